@@ -0,0 +1,103 @@
+/** @file
+    Lock-free pool of fixed-size blocks.
+
+    Blocks are taken and returned in O(1) by a compare-and-swap on the head of a
+    free list. No lock is held, so block_pool_acquire() and block_pool_release()
+    are safe to call from an ISR as well as from any task. The head carries a tag
+    changed on every swap, so a block taken and returned by another task between
+    reading and swapping the head does not corrupt the list.
+*/
+
+#ifndef INCLUDE_BLOCK_POOL_H_
+#define INCLUDE_BLOCK_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BLOCK_POOL_MAX_BLOCKS 0xfffe // Block indices are 16 bit
+#define BLOCK_POOL_NIL        0xffff // Ends the free list
+
+/// Counters of a pool, see block_pool_stats().
+typedef struct block_pool_stats {
+    unsigned blocks;      ///< Blocks in the pool.
+    unsigned in_use;      ///< Blocks currently acquired.
+    unsigned peak_in_use; ///< Most blocks acquired at once.
+    unsigned acquired;    ///< Successful acquisitions.
+    unsigned exhausted;   ///< Acquisitions that found no free block.
+} block_pool_stats_t;
+
+/// Pool of count blocks of block_size bytes each.
+typedef struct block_pool {
+    unsigned char *blocks;        ///< Storage of the blocks, provided to block_pool_init().
+    size_t block_size;
+    unsigned count;
+    uint16_t *next;               ///< Next free block of each free block.
+    volatile uint32_t head;       ///< Tag in the upper half, first free block in the lower half.
+    volatile uint32_t in_use;
+    volatile uint32_t peak_in_use;
+    volatile uint32_t acquired;
+    volatile uint32_t exhausted;
+} block_pool_t;
+
+/// Set up a pool on storage for count blocks of block_size bytes, returns 0 on success.
+///
+/// The storage stays owned by the caller, e.g. to place it in a particular memory,
+/// and must outlive the pool. The block size is rounded up to keep blocks aligned.
+int block_pool_init(block_pool_t *pool, void *blocks, unsigned count, size_t block_size);
+
+/// Storage size needed for count blocks of block_size bytes.
+size_t block_pool_storage_size(unsigned count, size_t block_size);
+
+/// Free the free list of a pool, the storage is left to the caller.
+void block_pool_free(block_pool_t *pool);
+
+/// Take a block, safe to call from an ISR. Returns NULL and counts the exhaustion if none is free.
+///
+/// The block is not cleared. Inline, so an ISR placed in IRAM does not call into flash.
+static inline void *block_pool_acquire(block_pool_t *pool)
+{
+    uint32_t head = __atomic_load_n(&pool->head, __ATOMIC_ACQUIRE);
+    uint32_t index;
+    for (;;) {
+        index = head & 0xffff;
+        if (index == BLOCK_POOL_NIL || !pool->count) {
+            __atomic_fetch_add(&pool->exhausted, 1, __ATOMIC_RELAXED);
+            return NULL;
+        }
+        // next may be stale if the block was taken meanwhile, the tag then fails the swap
+        uint32_t next = __atomic_load_n(&pool->next[index], __ATOMIC_RELAXED);
+        uint32_t swap = ((head + 0x10000) & 0xffff0000) | next;
+        if (__atomic_compare_exchange_n(&pool->head, &head, swap, 1, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            break;
+    }
+
+    __atomic_fetch_add(&pool->acquired, 1, __ATOMIC_RELAXED);
+    uint32_t in_use = __atomic_add_fetch(&pool->in_use, 1, __ATOMIC_RELAXED);
+    uint32_t peak   = __atomic_load_n(&pool->peak_in_use, __ATOMIC_RELAXED);
+    while (in_use > peak && !__atomic_compare_exchange_n(&pool->peak_in_use, &peak, in_use, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ; // peak was reloaded, retry while still below
+    return pool->blocks + index * pool->block_size;
+}
+
+/// Return a block taken with block_pool_acquire(), safe to call from an ISR.
+static inline void block_pool_release(block_pool_t *pool, void *block)
+{
+    uint32_t index = ((unsigned char *)block - pool->blocks) / pool->block_size;
+    uint32_t head  = __atomic_load_n(&pool->head, __ATOMIC_RELAXED);
+    do {
+        __atomic_store_n(&pool->next[index], (uint16_t)(head & 0xffff), __ATOMIC_RELAXED);
+    } while (!__atomic_compare_exchange_n(&pool->head, &head, ((head + 0x10000) & 0xffff0000) | index, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    __atomic_fetch_sub(&pool->in_use, 1, __ATOMIC_RELAXED);
+}
+
+/// Check whether p is a block of the pool, e.g. to tell it from a heap allocation.
+static inline int block_pool_owns(block_pool_t const *pool, void const *p)
+{
+    unsigned char const *c = (unsigned char const *)p;
+    return pool->blocks && c >= pool->blocks && c < pool->blocks + pool->count * pool->block_size;
+}
+
+/// Read the counters of a pool.
+void block_pool_stats(block_pool_t const *pool, block_pool_stats_t *stats);
+
+#endif /* INCLUDE_BLOCK_POOL_H_ */
@@ -38,6 +38,18 @@ r_device *decoder_create(r_device const *dev_template, unsigned user_data_size);
 /// The memory can be freely used by a decoder and is of the size given to `decoder_create()`.
 void *decoder_user_data(r_device *decoder);
 
+/// Get the receive time of the signal being decoded in microseconds, otherwise 0.
+///
+/// The clock is monotonic with an arbitrary origin, use it to time the gap between
+/// messages, e.g. to join a message sent in parts, instead of reading the wall clock.
+int64_t decoder_signal_time_us(r_device *decoder);
+
+/// Search a row for the preamble declared by the decoder.
+///
+/// Reuses the position located by the dispatcher where possible, the bitbuffer must not have been modified.
+/// @return the location of the first match, or the end of the row if no match is found.
+unsigned decoder_preamble_search(r_device *decoder, bitbuffer_t *bitbuffer, unsigned row);
+
 /// Output data.
 void decoder_output_data(r_device *decoder, data_t *data);
 
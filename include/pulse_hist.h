@@ -0,0 +1,57 @@
+/** @file
+    Compact pulse and gap width histogram of a pulse train.
+
+    Used by the dispatcher to skip decoders whose nominal timings have no
+    support in a signal, before any slicer runs, and to recognize repeated
+    timing signatures.
+*/
+
+#ifndef INCLUDE_PULSE_HIST_H_
+#define INCLUDE_PULSE_HIST_H_
+
+#include <stdint.h>
+#include "pulse_data.h"
+
+#define PULSE_HIST_BUCKET_US 8    // Bucket width in microseconds
+#define PULSE_HIST_BUCKETS   1024 // Number of buckets, widths beyond land in the last bucket
+#define PULSE_HIST_LOG_BITS  2    // Fingerprint width classes per octave, as a power of two
+
+#define PULSE_HIST_CLASSIFY_MIN_PULSES 8   // Shorter pulse trains are not classified
+#define PULSE_HIST_FSK_MAX_UNIT_US     150 // Bit widths below are taken as FSK
+#define PULSE_HIST_OOK_MIN_UNIT_US     200 // Bit widths from here on are taken as OOK
+
+/// Modulation family guessed from the timing of a pulse train.
+typedef enum pulse_hist_family {
+    PULSE_HIST_UNKNOWN, ///< Ambiguous, both slicer families should run.
+    PULSE_HIST_OOK,
+    PULSE_HIST_FSK,
+} pulse_hist_family_t;
+
+/// Occupancy bitmaps of pulse and gap widths, one bit per bucket.
+typedef struct pulse_hist {
+    uint32_t pulse[PULSE_HIST_BUCKETS / 32];
+    uint32_t gap[PULSE_HIST_BUCKETS / 32];
+} pulse_hist_t;
+
+/// Fill the histogram from the pulses and gaps of a pulse train.
+void pulse_hist_build(pulse_hist_t *hist, pulse_data_t const *pulses);
+
+/// Bucket holding a width in microseconds, clamped to the last bucket.
+unsigned pulse_hist_bucket(float width_us);
+
+/// Check if any width in the inclusive bucket range lo to hi is present in a bitmap.
+int pulse_hist_any(uint32_t const *map, unsigned lo, unsigned hi);
+
+/// Quantized timing signature of a pulse train.
+///
+/// Combines the pulse count in steps of 16 with the most frequent pulse width class
+/// and the most frequent gap width class, classes are a quarter octave wide.
+uint32_t pulse_hist_fingerprint(pulse_data_t const *pulses);
+
+/// Guess the modulation family of a pulse train.
+///
+/// FSK alternates mark and space at a high bit rate, so the shortest common width is small
+/// and the total mark and space times are balanced. OOK is slower or mostly carrier off.
+pulse_hist_family_t pulse_hist_classify(pulse_data_t const *pulses);
+
+#endif /* INCLUDE_PULSE_HIST_H_ */
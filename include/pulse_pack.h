@@ -0,0 +1,63 @@
+/** @file
+    Compact pulse trains, sized to their pulse count.
+
+    A pulse_data_t reserves PD_MAX_PULSES pulses and gaps as int, about 9.6 KB,
+    while a typical sensor sends 40 to 200 pulses shorter than 32 ms. A pack
+    keeps the widths in microseconds as 16-bit words, a width of 32768 us or more
+    as two words, so a typical pulse train takes a few hundred bytes.
+
+    Slicers still work on a pulse_data_t, pulse_pack_decode() fills one as a view
+    of the pack. The per-pulse rssi[] of SIGNAL_RSSI builds is not packed.
+*/
+
+#ifndef INCLUDE_PULSE_PACK_H_
+#define INCLUDE_PULSE_PACK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "pulse_data.h"
+
+#define PULSE_PACK_ESCAPE    0x8000     // Set in the first word of a two word width, holding bits 16 to 30
+#define PULSE_PACK_WIDTH_MAX 0x7fffffff // Longer widths are cut to this
+
+/// A pulse train in microseconds, widths[] holds the pulse and the gap of each pulse in turn.
+typedef struct pulse_pack {
+    uint16_t num_pulses;
+    uint16_t num_words;   ///< Words of widths[] in use.
+    int signalRssi;       ///< Copied from and to the pulse_data_t, as set by the receiver.
+    unsigned long signalDuration;
+    float centerfreq_hz;
+    float rssi_db;
+    float snr_db;
+    float noise_db;
+    uint16_t widths[];
+} pulse_pack_t;
+
+/// Size in bytes of a pack with room for max_words words.
+static inline size_t pulse_pack_size(unsigned max_words)
+{
+    return sizeof(pulse_pack_t) + max_words * sizeof(uint16_t);
+}
+
+/// Words needed to pack a pulse_data_t.
+unsigned pulse_pack_words(pulse_data_t const *data);
+
+/// Pack a pulse_data_t in microseconds into storage of pulse_pack_size(max_words) bytes.
+/// @return 0 on success, -1 if it needs more than max_words words, see pulse_pack_words()
+int pulse_pack_encode(pulse_pack_t *pack, unsigned max_words, pulse_data_t const *data);
+
+/// Fill a pulse_data_t with the pulse train of a pack, at a sample rate of 1 MHz.
+///
+/// Only the pulses, gaps and the fields of pulse_pack_t are written, the rest is cleared.
+void pulse_pack_decode(pulse_pack_t const *pack, pulse_data_t *data);
+
+/// Read the width at word *pos of a pack and advance *pos past it.
+static inline unsigned pulse_pack_next(pulse_pack_t const *pack, unsigned *pos)
+{
+    unsigned word = pack->widths[(*pos)++];
+    if (word & PULSE_PACK_ESCAPE)
+        return (word & ~PULSE_PACK_ESCAPE) << 16 | pack->widths[(*pos)++];
+    return word;
+}
+
+#endif /* INCLUDE_PULSE_PACK_H_ */
@@ -0,0 +1,86 @@
+/** @file
+    Lock-free ring of raw edge timestamps and a packetizer turning it into pulse trains.
+
+    The ring has a single producer, typically a GPIO interrupt handler, and a
+    single consumer, the decoder task. pulse_ring_push() is inline and never
+    blocks or allocates, so an ISR has a fixed cost per edge.
+*/
+
+#ifndef INCLUDE_PULSE_RING_H_
+#define INCLUDE_PULSE_RING_H_
+
+#include <stdint.h>
+#include "pulse_data.h"
+
+#define PULSE_RING_MIN_SIZE 64 // Smaller rings are rounded up
+
+/// A level change of the receiver output.
+typedef struct pulse_edge {
+    uint32_t time_us; ///< Timestamp in microseconds, may wrap.
+    uint32_t level;   ///< Level after the edge, 1 for mark and 0 for space.
+} pulse_edge_t;
+
+/// Single producer single consumer ring of edges.
+typedef struct pulse_ring {
+    pulse_edge_t *edges;
+    uint32_t mask;               ///< Number of edges minus one, the size is a power of two.
+    volatile uint32_t head;      ///< Next slot to write, only written by the producer.
+    volatile uint32_t tail;      ///< Next slot to read, only written by the consumer.
+    volatile uint32_t overflows; ///< Edges dropped as the ring was full, only written by the producer.
+} pulse_ring_t;
+
+/// Allocate a ring for at least size edges, returns 0 on success.
+int pulse_ring_init(pulse_ring_t *ring, unsigned size);
+
+/// Free the edges of a ring.
+void pulse_ring_free(pulse_ring_t *ring);
+
+/// Add an edge, safe to call from an ISR. Drops the edge and counts an overflow if the ring is full.
+static inline void pulse_ring_push(pulse_ring_t *ring, uint32_t time_us, int level)
+{
+    uint32_t head = ring->head;
+    if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) > ring->mask) {
+        ring->overflows++;
+        return;
+    }
+    pulse_edge_t *edge = &ring->edges[head & ring->mask];
+    edge->time_us = time_us;
+    edge->level   = level != 0;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+/// Take the oldest edge, returns 0 if the ring is empty. Consumer only.
+int pulse_ring_pop(pulse_ring_t *ring, pulse_edge_t *edge);
+
+/// Assembles edges into pulse trains, ending a train on a gap as pulse_detect does.
+typedef struct pulse_packetizer {
+    pulse_data_t *data;     ///< Pulse train being assembled, in microseconds.
+    int state;              ///< Idle, in a pulse or in a gap.
+    uint32_t edge_us;       ///< Time of the last edge taken.
+    int max_pulse;          ///< Widest pulse of the train, for the gap ratio.
+    int pending;            ///< The rising edge at edge_us starts the next train once data is handed out.
+    uint32_t overflows;     ///< Ring overflows seen, a train spanning new ones is dropped.
+    unsigned packages;      ///< Pulse trains handed out.
+    unsigned short_trains;  ///< Trains dropped for having less than PD_MIN_PULSES pulses.
+    unsigned broken_trains; ///< Trains dropped because edges were lost to ring overflows.
+} pulse_packetizer_t;
+
+/// Allocate the pulse train buffer of a packetizer, returns 0 on success.
+int pulse_packetizer_init(pulse_packetizer_t *pk);
+
+/// Free the pulse train buffer of a packetizer.
+void pulse_packetizer_free(pulse_packetizer_t *pk);
+
+/// Take edges from the ring until a pulse train is complete.
+///
+/// A train ends on a gap longer than PD_MIN_GAP_MS and PD_MAX_GAP_RATIO times its widest pulse,
+/// or longer than PD_MAX_GAP_MS, including a gap still running at now_us. Trains also end at
+/// PD_MAX_PULSES pulses or on a pulse longer than PD_MAX_PULSE_MS.
+///
+/// @param pk The packetizer
+/// @param ring The ring to take edges from
+/// @param now_us Current time on the clock of the edge timestamps
+/// @return the completed pulse train, valid until the next call, or NULL if none is complete yet
+pulse_data_t *pulse_packetizer_run(pulse_packetizer_t *pk, pulse_ring_t *ring, uint32_t now_us);
+
+#endif /* INCLUDE_PULSE_RING_H_ */
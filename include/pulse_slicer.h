@@ -16,6 +16,20 @@
 
 #include "pulse_detect.h"
 #include "r_device.h"
+#include "bitbuffer.h"
+
+struct dispatch_dev;
+
+/// Slicer state of one decoder instance or worker.
+///
+/// Each thread slicing concurrently needs its own context,
+/// the bitbuffers are too large to keep on a small task stack.
+typedef struct pulse_slicer_ctx {
+    bitbuffer_t bits;      ///< Slice being accumulated.
+    bitbuffer_t bits_view; ///< Private copy of a slice for devices sharing it.
+    struct dispatch_dev *devs; ///< Dispatcher state by protocol_num, set by the dispatcher, NULL if sliced without it.
+    int timed;                 ///< Measure decode times into devs, set by the dispatcher while ordering by hits per cost.
+} pulse_slicer_ctx_t;
 
 /// Demodulate a Pulse Code Modulation signal.
 ///
@@ -27,6 +41,7 @@
 /// - Presence of a pulse equals 1
 /// - Absence of a pulse equals 0
 ///
+/// @param ctx Slicer state of the calling instance
 /// @param pulses The pulse sequence to demodulate
 /// @param device Modulation parameters of
 /// - short_width: Nominal width of pulse [us]
@@ -35,7 +50,7 @@
 /// - reset_limit: Maximum gap size before End Of Message [us].
 /// - tolerance:   Maximum deviation from nominal widths (optional, default 25%) [us]
 /// @return number of events processed
-int pulse_slicer_pcm(pulse_data_t const *pulses, r_device *device);
+int pulse_slicer_pcm(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device *device);
 
 /// Demodulate a Pulse Position Modulation signal.
 ///
@@ -45,6 +60,7 @@ int pulse_slicer_pcm(pulse_data_t const *pulses, r_device *device);
 /// - Short gap will add a 0 bit
 /// - Long  gap will add a 1 bit
 ///
+/// @param ctx Slicer state of the calling instance
 /// @param pulses The pulse sequence to demodulate
 /// @param device Modulation parameters of
 /// - short_width: Nominal width of '0' [us]
@@ -53,7 +69,7 @@ int pulse_slicer_pcm(pulse_data_t const *pulses, r_device *device);
 /// - gap_limit:   Maximum gap size before new row of bits [us]
 /// - tolerance:   Maximum deviation from nominal widths (optional, raw if 0) [us]
 /// @return number of events processed
-int pulse_slicer_ppm(pulse_data_t const *pulses, r_device *device);
+int pulse_slicer_ppm(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device *device);
 
 /// Demodulate a Pulse Width Modulation signal.
 ///
@@ -63,6 +79,7 @@ int pulse_slicer_ppm(pulse_data_t const *pulses, r_device *device);
 /// - Long pulse will add a 0 bit
 /// - Sync pulse (optional) will add a new row to bitbuffer
 ///
+/// @param ctx Slicer state of the calling instance
 /// @param pulses The pulse sequence to demodulate
 /// @param device Modulation parameters of
 /// - short_width: Nominal width of '1' [us]
@@ -72,7 +89,7 @@ int pulse_slicer_ppm(pulse_data_t const *pulses, r_device *device);
 /// - sync_width:  Nominal width of sync pulse (optional) [us]
 /// - tolerance:   Maximum deviation from nominal widths (optional, raw if 0) [us]
 /// @return number of events processed
-int pulse_slicer_pwm(pulse_data_t const *pulses, r_device *device);
+int pulse_slicer_pwm(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device *device);
 
 /// Demodulate a Manchester encoded signal with a hardcoded zerobit in front.
 ///
@@ -84,13 +101,14 @@ int pulse_slicer_pwm(pulse_data_t const *pulses, r_device *device);
 /// - Rising edge means bit = 0
 /// - Falling edge means bit = 1
 ///
+/// @param ctx Slicer state of the calling instance
 /// @param pulses The pulse sequence to demodulate
 /// @param device Modulation parameters of
 /// - short_width: Nominal width of clock half period [us]
 /// - long_width:  Not used
 /// - reset_limit: Maximum gap size before End Of Message [us].
 /// @return number of events processed
-int pulse_slicer_manchester_zerobit(pulse_data_t const *pulses, r_device *device);
+int pulse_slicer_manchester_zerobit(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device *device);
 
 /// Demodulate a Differential Manchester Coded signal.
 ///
@@ -106,6 +124,7 @@ int pulse_slicer_manchester_zerobit(pulse_data_t const *pulses, r_device *device
 ///     ^       ^       ^       ^       ^  clock cycle
 ///     |   1   |   1   |   0   |   0   |  translates as
 ///
+/// @param ctx Slicer state of the calling instance
 /// @param pulses The pulse sequence to demodulate
 /// @param device Modulation parameters of
 /// - short_width: Width in samples of '1' [us]
@@ -113,13 +132,14 @@ int pulse_slicer_manchester_zerobit(pulse_data_t const *pulses, r_device *device
 /// - reset_limit: Maximum gap size before End Of Message [us].
 /// - tolerance:   Maximum deviation from nominal widths [us]
 /// @return number of events processed
-int pulse_slicer_dmc(pulse_data_t const *pulses, r_device *device);
+int pulse_slicer_dmc(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device *device);
 
 /// Demodulate a raw Pulse Interval and Width Modulation signal.
 ///
 /// Each level shift is a new bit.
 /// A short interval is a logic 1, a long interval a logic 0
 ///
+/// @param ctx Slicer state of the calling instance
 /// @param pulses The pulse sequence to demodulate
 /// @param device Modulation parameters of
 /// - short_width: Nominal width of a bit [us]
@@ -127,13 +147,14 @@ int pulse_slicer_dmc(pulse_data_t const *pulses, r_device *device);
 /// - reset_limit: Maximum gap size before End Of Message [us].
 /// - tolerance:   Maximum deviation from nominal widths [us]
 /// @return number of events processed
-int pulse_slicer_piwm_raw(pulse_data_t const *pulses, r_device *device);
+int pulse_slicer_piwm_raw(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device *device);
 
 /// Demodulate a differential Pulse Interval and Width Modulation signal.
 ///
 /// Each level shift is a new bit.
 /// A short interval is a logic 1, a long interval a logic 0
 ///
+/// @param ctx Slicer state of the calling instance
 /// @param pulses The pulse sequence to demodulate
 /// @param device Modulation parameters of
 /// - short_width: Nominal width of '1' [us]
@@ -141,11 +162,11 @@ int pulse_slicer_piwm_raw(pulse_data_t const *pulses, r_device *device);
 /// - reset_limit: Maximum gap size before End Of Message [us].
 /// - tolerance:   Maximum deviation from nominal widths [us]
 /// @return number of events processed
-int pulse_slicer_piwm_dc(pulse_data_t const *pulses, r_device *device);
+int pulse_slicer_piwm_dc(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device *device);
 
-int pulse_slicer_nrzs(pulse_data_t const *pulses, r_device *device);
+int pulse_slicer_nrzs(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device *device);
 
-int pulse_slicer_osv1(pulse_data_t const *pulses, r_device *device);
+int pulse_slicer_osv1(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device *device);
 
 /// Simulate demodulation using a given signal code string.
 ///
@@ -153,9 +174,10 @@ int pulse_slicer_osv1(pulse_data_t const *pulses, r_device *device);
 /// Each row is optionally prefixed with a length enclosed in braces "{}" or
 /// separated with a slash "/" character. Whitespace is ignored.
 ///
+/// @param ctx Slicer state of the calling instance
 /// @param code The pulse sequence to demodulate in text format
 /// @param device Device params are disregarded.
 /// @return number of events processed
-int pulse_slicer_string(const char *code, r_device *device);
+int pulse_slicer_string(pulse_slicer_ctx_t *ctx, const char *code, r_device *device);
 
 #endif /* INCLUDE_PULSE_SLICER_H_ */
@@ -12,14 +12,19 @@
 #ifndef INCLUDE_R_API_H_
 #define INCLUDE_R_API_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 struct r_cfg;
 struct r_device;
 struct data;
 struct pulse_data;
+struct pulse_slicer_ctx;
 struct list;
+struct dm_state;
 struct mg_mgr;
+struct decoder_stats;
+struct dispatch_stats;
 
 /* general */
 
@@ -51,9 +56,18 @@ char const **well_known_output_fields(struct r_cfg *cfg);
 
 char const **determine_csv_fields(struct r_cfg *cfg, char const *const *well_known, int *num_fields);
 
-int run_ook_demods(struct list *r_devs, struct pulse_data *pulse_data);
+int run_ook_demods(struct dm_state *demod, struct pulse_slicer_ctx *ctx, struct pulse_data *pulse_data);
 
-int run_fsk_demods(struct list *r_devs, struct pulse_data *fsk_pulse_data);
+int run_fsk_demods(struct dm_state *demod, struct pulse_slicer_ctx *ctx, struct pulse_data *fsk_pulse_data);
+
+/// Runs fn(arg, part) for every part below num_parts concurrently, returns once all of them returned.
+typedef void (*dispatch_fork_fn)(void *fork_ctx, void (*fn)(void *arg, unsigned part), void *arg, unsigned num_parts);
+
+int run_ook_demods_split(struct dm_state *demod, struct pulse_slicer_ctx **ctxs, unsigned num_parts,
+        dispatch_fork_fn fork, void *fork_ctx, struct pulse_data *pulse_data);
+
+int run_fsk_demods_split(struct dm_state *demod, struct pulse_slicer_ctx **ctxs, unsigned num_parts,
+        dispatch_fork_fn fork, void *fork_ctx, struct pulse_data *fsk_pulse_data);
 
 /* handlers */
 
@@ -66,6 +80,7 @@ void log_device_handler(struct r_device *r_dev, int level, struct data *data);
 void data_acquired_handler(struct r_device *r_dev, struct data *data);
 
 struct data *create_report_data(struct r_cfg *cfg, int level);
+struct data *create_dispatch_report(struct r_cfg *const *cfgs, unsigned num_cfgs);
 
 void flush_report_data(struct r_cfg *cfg);
 
@@ -118,5 +133,22 @@ void set_freq_correction(struct r_cfg *cfg, int freq_correction);
 void set_sample_rate(struct r_cfg *cfg, uint32_t sample_rate);
 
 void set_gain_str(struct r_cfg *cfg, char const *gain_str);
+/// Orders of the decoders within a priority level, see set_adaptive_order().
+enum dispatch_order {
+    DISPATCH_ORDER_REGISTRATION,  ///< Registration order.
+    DISPATCH_ORDER_HITS,          ///< Most successful decoders first.
+    DISPATCH_ORDER_HITS_PER_COST, ///< Highest success per decode time first.
+};
+
+void set_adaptive_order(struct r_cfg *cfg, int enable, int first_hit_stop);
+void set_fingerprint_cache(struct r_cfg *cfg, unsigned size);
+void set_demotion_policy(struct r_cfg *cfg, unsigned after_runs, unsigned sample);
+void set_decode_budget(struct r_cfg *cfg, unsigned budget_us);
+int set_device_urgent(struct r_cfg *cfg, char const *name, int urgent);
+void set_urgent_signal(struct r_cfg *cfg, int urgent);
+size_t save_dispatch_model(struct r_cfg *const *cfgs, unsigned num_cfgs, void *buf, size_t size);
+int load_dispatch_model(struct r_cfg *cfg, void const *buf, size_t size);
+int add_decoder_stats(struct r_cfg *cfg, struct decoder_stats *stats, unsigned count);
+void add_dispatch_stats(struct r_cfg *cfg, struct dispatch_stats *stats);
 
 #endif /* INCLUDE_R_API_H_ */
@@ -5,6 +5,8 @@
 #ifndef INCLUDE_R_DEVICE_H_
 #define INCLUDE_R_DEVICE_H_
 
+#include <stdint.h>
+
 /**
     Supported Modulation and Coding types.
 
@@ -72,6 +74,12 @@ typedef struct r_device {
     unsigned priority; ///< Run later and only if no previous events were produced
     unsigned disabled; ///< 0: default enabled, 1: default disabled, 2: disabled, 3: disabled and hidden
     char const *const *fields; ///< List of fields this decoder produces; required for CSV output. NULL-terminated.
+    unsigned min_rows; ///< Minimum number of rows the decoder accepts, 0 for no limit; checked before calling decode_fn.
+    unsigned max_rows; ///< Maximum number of rows the decoder accepts, 0 for no limit; checked before calling decode_fn.
+    unsigned min_bits; ///< At least one row needs this many bits, 0 for no limit; checked before calling decode_fn.
+    unsigned max_bits; ///< At least one row needs at most this many bits, 0 for no limit; checked together with min_bits.
+    uint8_t const *preamble; ///< Pattern that needs to be present in at least one row, NULL for none; checked before calling decode_fn.
+    unsigned preamble_bits; ///< Length of the preamble pattern in bits.
 
     /* public for each decoder */
     int verbose;
@@ -84,10 +92,15 @@ typedef struct r_device {
     unsigned decode_ok;
     unsigned decode_messages;
     unsigned decode_fails[5];
+    unsigned stats_seq; ///< Odd while the statistics above change, see add_decoder_stats().
 
     /* private for flex decoder and output callback */
     void *decode_ctx;
     void *output_ctx;
+
+    /* set by the slicer before calling decode_fn, see decoder_preamble_search() */
+    unsigned preamble_row; ///< First row containing the declared preamble.
+    unsigned preamble_pos; ///< Bit position of the declared preamble in that row.
 } r_device;
 
 #endif /* INCLUDE_R_DEVICE_H_ */
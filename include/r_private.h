@@ -15,6 +15,112 @@
 // #include "am_analyze.h"
 #include "rtl_433.h"
 #include "compat_time.h"
+#include "pulse_hist.h"
+
+struct r_device;
+struct pulse_slicer_ctx;
+
+/// Slicer entry point as resolved from a device modulation.
+typedef int (*pulse_slicer_fn)(struct pulse_slicer_ctx *ctx, pulse_data_t const *pulses, struct r_device *device);
+
+/// Dispatcher state of one registered device, kept out of r_device so the decoders and
+/// the r_devices[] templates do not carry it, see dm_state.devs.
+typedef struct dispatch_dev {
+    struct r_device *r_dev;      ///< Device registered with this protocol number, NULL if none.
+    struct r_device *slice_next; ///< Next device with identical slicer parameters, decoded from the same slice.
+    unsigned demoted;            ///< Set while the decoder never succeeded and only runs on sampled signals.
+    unsigned sample_countdown;   ///< Signals left until the next sampled run while demoted.
+    unsigned dispatch_skip;      ///< Set to leave a demoted decoder out of the current signal.
+    unsigned budget_skips;       ///< Signals the decoder was left out of because the decode time budget was spent.
+    unsigned cost_ns;            ///< Exponentially weighted average decode_fn time in nanoseconds, 0 if never run.
+    unsigned prior_hits;         ///< Successful decodes restored from a saved dispatch model, see load_dispatch_model().
+    unsigned urgent;             ///< Run first within its priority on urgent signals, see set_device_urgent().
+} dispatch_dev_t;
+
+/// Width histogram support a dispatch entry needs to be worth slicing, see pulse_hist.h.
+typedef enum dispatch_filter {
+    DISPATCH_FILTER_NONE,  ///< Always run.
+    DISPATCH_FILTER_PULSE, ///< Run only if a pulse width lies in one of the ranges.
+    DISPATCH_FILTER_GAP,   ///< Run only if a gap width lies in one of the ranges.
+    DISPATCH_FILTER_ANY,   ///< Run only if a pulse or gap width lies in one of the ranges.
+} dispatch_filter_t;
+
+/// One decoder of a dispatch plan: the resolved slicer and the device it runs.
+typedef struct dispatch_entry {
+    pulse_slicer_fn slicer;
+    struct r_device *r_dev;
+    dispatch_filter_t filter;
+    uint16_t range_lo[2]; ///< Histogram bucket ranges for the filter, inclusive.
+    uint16_t range_hi[2]; ///< An unused range has range_lo > range_hi.
+    unsigned hits; ///< Successful decodes of the chained devices as of the last adaptive reorder.
+    unsigned cost_ns; ///< Summed average decode time of the chained devices as of the last adaptive reorder.
+} dispatch_entry_t;
+
+/// A run of consecutive dispatch entries sharing one priority.
+typedef struct dispatch_level {
+    unsigned priority;
+    unsigned first; ///< Index of the first entry of this level.
+    unsigned count; ///< Number of entries in this level.
+} dispatch_level_t;
+
+/// Fingerprint cache slot: the dispatch entry that last decoded a timing signature.
+typedef struct dispatch_cache_slot {
+    uint32_t fingerprint; ///< See pulse_hist_fingerprint().
+    pulse_slicer_fn slicer;
+    struct r_device *r_dev; ///< First device of the dispatch entry.
+} dispatch_cache_slot_t;
+
+/// LRU cache of timing signatures, slots ordered most recently used first.
+typedef struct dispatch_cache {
+    dispatch_cache_slot_t *slots;
+    unsigned size; ///< Number of slots, 0 if the cache is disabled.
+    unsigned used;
+} dispatch_cache_t;
+
+/// Precompiled dispatch plan, entries sorted by ascending priority, stable in registration order.
+typedef struct dispatch_plan {
+    dispatch_entry_t *entries;
+    unsigned num_entries;
+    dispatch_level_t *levels;
+    unsigned num_levels;
+    dispatch_cache_t cache; ///< Cleared whenever the plan is rebuilt.
+} dispatch_plan_t;
+
+/// Default number of dispatched signals between adaptive reorders, see set_adaptive_order().
+#define DISPATCH_ADAPTIVE_PERIOD 64
+
+/// Default number of signals, one in which demoted decoders still run, see set_demotion_policy().
+#define DISPATCH_DEMOTE_SAMPLE 16
+
+/// Maximum number of partitions a level is split into, see run_ook_demods_split().
+#define DISPATCH_MAX_PARTS 8
+
+/// Counters of the dispatcher, for measuring the effect of the dispatch settings.
+typedef struct dispatch_stats {
+    unsigned signals;         ///< Pulse trains dispatched.
+    unsigned reorders;        ///< Adaptive reorders of the dispatch plans.
+    unsigned first_hit_stops; ///< Priority levels cut short at the first decoder producing events.
+    unsigned first_hit_skips; ///< Dispatch entries not run because of first hit stops.
+    unsigned cache_hits;      ///< Signals whose fingerprint was cached.
+    unsigned cache_misses;    ///< Signals whose fingerprint was not cached, with the cache enabled.
+    unsigned cache_stale;     ///< Cache hits where the cached decoder found no events.
+    unsigned demotions;       ///< Decoders demoted to sampled runs.
+    unsigned promotions;      ///< Demoted decoders promoted back on a success.
+    unsigned demoted_skips;   ///< Decoder runs left out while demoted.
+    unsigned budget_exhausted; ///< Signals whose decode time budget was spent before all decoders ran.
+    unsigned budget_skips;    ///< Dispatch entries left out because the decode time budget was spent.
+    unsigned urgent_signals;  ///< Signals dispatched with the urgent devices of each level first.
+} dispatch_stats_t;
+
+/// Statistics of one registered decoder, see add_decoder_stats().
+typedef struct decoder_stats {
+    unsigned protocol_num;
+    char const *name;
+    unsigned events;   ///< Runs of the decoder.
+    unsigned ok;       ///< Runs producing messages.
+    unsigned messages; ///< Messages produced.
+    unsigned fails[5]; ///< Runs ending in each decode_return_codes, by its negated value.
+} decoder_stats_t;
 
 struct dm_state {
     /*
@@ -52,6 +158,23 @@ struct dm_state {
     */
     /* Protocol states */
     list_t r_devs;
+    dispatch_dev_t *devs;        ///< Dispatcher state of the registered devices, indexed by protocol_num.
+    unsigned num_devs;           ///< Size of devs.
+    dispatch_plan_t ook_plan; ///< OOK decoders only, built from r_devs.
+    dispatch_plan_t fsk_plan; ///< FSK decoders only, built from r_devs.
+    int plans_stale;             ///< A protocol was registered, the plans are rebuilt with the next signal.
+    int adaptive_order;          ///< Requested: order of each priority level, a dispatch_order value.
+    int adaptive_applied;        ///< Applied by the dispatcher, plans are restored when the request is cleared.
+    int first_hit_stop;          ///< Stop a priority level at the first decoder producing events.
+    unsigned adaptive_period;    ///< Dispatched signals between adaptive reorders.
+    unsigned adaptive_countdown; ///< Dispatched signals left until the next adaptive reorder.
+    int model_loaded;            ///< Requested: reorder with the next signal as a dispatch model was loaded.
+    unsigned cache_size;         ///< Requested fingerprint cache slots per plan, 0 to disable.
+    unsigned demote_after;       ///< Runs without any success before a decoder is demoted, 0 to disable.
+    unsigned demote_sample;      ///< Demoted decoders run on one in this many signals.
+    unsigned budget_us;          ///< Decode time budget per signal in microseconds, 0 for no limit.
+    int urgent_signal;           ///< The signals dispatched next are urgent, see set_urgent_signal().
+    dispatch_stats_t dispatch_stats;
 
     /*
     pulse_data_t    pulse_data;
@@ -137,6 +137,9 @@ typedef struct r_cfg {
   //  TODO: rtl_433_Decoder_ESP additions
   //
   void *ctx;           // context pointer for callback
+  int report_source;   ///< add the source of the signal to each message
+  int source;          ///< receiver the signal being decoded came from
+  int64_t signal_us;   ///< receive time of the signal being decoded, microseconds on a monotonic clock
   
   /**
    * callback to controlling program to be executed when a message is received.
@@ -0,0 +1,256 @@
+/*
+  rtl_433_Decoder_ESP - 433.92 MHz protocols library for ESP32
+    based on rtl_433_ESP
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3 of the License, or (at your option) any later version.
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with library. If not, see <http://www.gnu.org/licenses/>
+
+
+  pthread backend of decoderPort.h, for running the decoder on a host.
+
+*/
+
+#include "decoderPort.h"
+
+#if !defined(ESP_PLATFORM)
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+struct port_queue {
+  pthread_mutex_t lock;
+  pthread_cond_t changed; ///< signalled on every send and receive
+  unsigned char* items;
+  size_t item_size;
+  unsigned length;
+  unsigned head; ///< next item to receive
+  unsigned count;
+};
+
+struct port_sem {
+  pthread_mutex_t lock;
+  pthread_cond_t given;
+  unsigned count;
+  unsigned max_count;
+};
+
+struct port_task {
+  pthread_t thread;
+  void (*fn)(void*);
+  void* arg;
+};
+
+/// Absolute CLOCK_MONOTONIC deadline timeout_ms from now, for pthread_cond_timedwait()
+static void deadline_after(struct timespec* deadline, uint32_t timeout_ms) {
+  clock_gettime(CLOCK_MONOTONIC, deadline);
+  deadline->tv_sec += timeout_ms / 1000;
+  deadline->tv_nsec += (long)(timeout_ms % 1000) * 1000000;
+  if (deadline->tv_nsec >= 1000000000) {
+    deadline->tv_sec++;
+    deadline->tv_nsec -= 1000000000;
+  }
+}
+
+static void cond_init(pthread_cond_t* cond) {
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(cond, &attr);
+  pthread_condattr_destroy(&attr);
+}
+
+/// Wait on cond until ready() holds, false once the timeout is over. The lock is held.
+template <typename Ready>
+static bool cond_wait_until(pthread_cond_t* cond, pthread_mutex_t* lock, uint32_t timeout_ms, Ready ready) {
+  if (ready()) {
+    return true;
+  }
+  if (timeout_ms == 0) {
+    return false;
+  }
+  if (timeout_ms == PORT_FOREVER) {
+    while (!ready()) {
+      pthread_cond_wait(cond, lock);
+    }
+    return true;
+  }
+  struct timespec deadline;
+  deadline_after(&deadline, timeout_ms);
+  while (!ready()) {
+    if (pthread_cond_timedwait(cond, lock, &deadline) == ETIMEDOUT) {
+      return ready();
+    }
+  }
+  return true;
+}
+
+port_queue_t port_queue_create(unsigned length, size_t item_size) {
+  port_queue_t queue = (port_queue_t)calloc(1, sizeof(struct port_queue));
+  if (!queue) {
+    return nullptr;
+  }
+  queue->items = (unsigned char*)calloc(length, item_size);
+  if (!queue->items) {
+    free(queue);
+    return nullptr;
+  }
+  pthread_mutex_init(&queue->lock, nullptr);
+  cond_init(&queue->changed);
+  queue->item_size = item_size;
+  queue->length = length;
+  return queue;
+}
+
+bool port_queue_send(port_queue_t queue, const void* item, uint32_t timeout_ms) {
+  pthread_mutex_lock(&queue->lock);
+  bool room = cond_wait_until(&queue->changed, &queue->lock, timeout_ms, [queue] { return queue->count < queue->length; });
+  if (room) {
+    unsigned tail = (queue->head + queue->count) % queue->length;
+    memcpy(queue->items + tail * queue->item_size, item, queue->item_size);
+    queue->count++;
+    pthread_cond_broadcast(&queue->changed);
+  }
+  pthread_mutex_unlock(&queue->lock);
+  return room;
+}
+
+bool port_queue_receive(port_queue_t queue, void* item, uint32_t timeout_ms) {
+  pthread_mutex_lock(&queue->lock);
+  bool ready = cond_wait_until(&queue->changed, &queue->lock, timeout_ms, [queue] { return queue->count > 0; });
+  if (ready) {
+    memcpy(item, queue->items + queue->head * queue->item_size, queue->item_size);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    pthread_cond_broadcast(&queue->changed);
+  }
+  pthread_mutex_unlock(&queue->lock);
+  return ready;
+}
+
+unsigned port_queue_waiting(port_queue_t queue) {
+  pthread_mutex_lock(&queue->lock);
+  unsigned count = queue->count;
+  pthread_mutex_unlock(&queue->lock);
+  return count;
+}
+
+port_sem_t port_sem_create(unsigned max_count, unsigned initial_count) {
+  port_sem_t sem = (port_sem_t)calloc(1, sizeof(struct port_sem));
+  if (!sem) {
+    return nullptr;
+  }
+  pthread_mutex_init(&sem->lock, nullptr);
+  cond_init(&sem->given);
+  sem->count = initial_count;
+  sem->max_count = max_count;
+  return sem;
+}
+
+/// A mutex is a semaphore given once, as in FreeRTOS. There is no priority inheritance.
+port_sem_t port_mutex_create() {
+  return port_sem_create(1, 1);
+}
+
+bool port_sem_take(port_sem_t sem, uint32_t timeout_ms) {
+  pthread_mutex_lock(&sem->lock);
+  bool taken = cond_wait_until(&sem->given, &sem->lock, timeout_ms, [sem] { return sem->count > 0; });
+  if (taken) {
+    sem->count--;
+  }
+  pthread_mutex_unlock(&sem->lock);
+  return taken;
+}
+
+void port_sem_give(port_sem_t sem) {
+  pthread_mutex_lock(&sem->lock);
+  if (sem->count < sem->max_count) {
+    sem->count++;
+    pthread_cond_signal(&sem->given);
+  }
+  pthread_mutex_unlock(&sem->lock);
+}
+
+static void* task_main(void* arg) {
+  port_task_t task = (port_task_t)arg;
+  task->fn(task->arg);
+  return nullptr;
+}
+
+bool port_task_create(void (*fn)(void*), const char* name, unsigned stack, void* arg,
+                      unsigned priority, int core, port_task_t* handle) {
+  (void)priority;
+  port_task_t task = (port_task_t)calloc(1, sizeof(struct port_task));
+  if (!task) {
+    return false;
+  }
+  task->fn = fn;
+  task->arg = arg;
+
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  size_t default_stack = 0;
+  pthread_attr_getstacksize(&attr, &default_stack);
+  if (stack > default_stack) {
+    pthread_attr_setstacksize(&attr, stack);
+  }
+#if defined(__linux__) && defined(_GNU_SOURCE)
+  if (core != PORT_NO_AFFINITY) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(core % port_num_cores(), &cpus);
+    pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus);
+  }
+#else
+  (void)core;
+#endif
+  bool started = pthread_create(&task->thread, &attr, task_main, task) == 0;
+  pthread_attr_destroy(&attr);
+  if (!started) {
+    free(task);
+    return false;
+  }
+#if defined(__linux__) && defined(_GNU_SOURCE)
+  char thread_name[16]; // the kernel limit
+  snprintf(thread_name, sizeof(thread_name), "%s", name);
+  pthread_setname_np(task->thread, thread_name);
+#else
+  (void)name;
+#endif
+  if (handle) {
+    *handle = task;
+  }
+  return true;
+}
+
+int port_num_cores() {
+  long cores = sysconf(_SC_NPROCESSORS_ONLN);
+  return cores > 0 ? (int)cores : 1;
+}
+
+void port_delay_ms(uint32_t ms) {
+  struct timespec delay = {(time_t)(ms / 1000), (long)(ms % 1000) * 1000000};
+  while (nanosleep(&delay, &delay) && errno == EINTR) {
+  }
+}
+
+int64_t port_now_us() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+#endif
@@ -0,0 +1,143 @@
+/*
+  rtl_433_Decoder_ESP - 433.92 MHz protocols library for ESP32
+    based on rtl_433_ESP
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3 of the License, or (at your option) any later version.
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with library. If not, see <http://www.gnu.org/licenses/>
+
+
+  Tasks, queues, semaphores, clock and allocator used by rtl_433_Decoder.
+
+  On ESP32 they map onto FreeRTOS and the ESP-IDF heap, elsewhere onto
+  pthreads, see decoderPort.cpp. Timeouts are in milliseconds.
+
+*/
+
+#ifndef rtl_433_DECODER_PORT_H
+#define rtl_433_DECODER_PORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define PORT_FOREVER UINT32_MAX // timeout waiting without limit
+
+#if defined(ESP_PLATFORM)
+
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+typedef QueueHandle_t port_queue_t;
+typedef SemaphoreHandle_t port_sem_t;
+typedef TaskHandle_t port_task_t;
+
+#define PORT_NO_AFFINITY tskNO_AFFINITY
+
+static inline TickType_t port_ticks(uint32_t ms) {
+  return ms == PORT_FOREVER ? portMAX_DELAY : pdMS_TO_TICKS(ms);
+}
+
+static inline port_queue_t port_queue_create(unsigned length, size_t item_size) {
+  return xQueueCreate(length, item_size);
+}
+static inline bool port_queue_send(port_queue_t queue, const void* item, uint32_t timeout_ms) {
+  return xQueueSend(queue, item, port_ticks(timeout_ms)) == pdTRUE;
+}
+static inline bool port_queue_receive(port_queue_t queue, void* item, uint32_t timeout_ms) {
+  return xQueueReceive(queue, item, port_ticks(timeout_ms)) == pdTRUE;
+}
+static inline unsigned port_queue_waiting(port_queue_t queue) {
+  return uxQueueMessagesWaiting(queue);
+}
+
+static inline port_sem_t port_mutex_create() {
+  return xSemaphoreCreateMutex();
+}
+static inline port_sem_t port_sem_create(unsigned max_count, unsigned initial_count) {
+  return max_count == 1 && initial_count == 0 ? xSemaphoreCreateBinary() : xSemaphoreCreateCounting(max_count, initial_count);
+}
+static inline bool port_sem_take(port_sem_t sem, uint32_t timeout_ms) {
+  return xSemaphoreTake(sem, port_ticks(timeout_ms)) == pdTRUE;
+}
+static inline void port_sem_give(port_sem_t sem) {
+  xSemaphoreGive(sem);
+}
+
+/// Start a task, pinned to core unless PORT_NO_AFFINITY. Stack size in bytes.
+static inline bool port_task_create(void (*fn)(void*), const char* name, unsigned stack, void* arg,
+                                    unsigned priority, int core, port_task_t* handle) {
+  return xTaskCreatePinnedToCore(fn, name, stack, arg, priority, handle, core) == pdPASS;
+}
+static inline int port_num_cores() {
+  return portNUM_PROCESSORS;
+}
+
+/// Block the calling task for at least ms, and at least one tick
+static inline void port_delay_ms(uint32_t ms) {
+  TickType_t ticks = pdMS_TO_TICKS(ms);
+  vTaskDelay(ticks ? ticks : 1);
+}
+
+/// Microseconds from a monotonic clock
+static inline int64_t port_now_us() {
+  return esp_timer_get_time();
+}
+
+/// Allocate from internal RAM, for buffers the decoders walk through
+static inline void* port_malloc(size_t size) {
+  return heap_caps_malloc(size, MALLOC_CAP_INTERNAL);
+}
+static inline void* port_calloc(size_t count, size_t size) {
+  return heap_caps_calloc(count, size, MALLOC_CAP_INTERNAL);
+}
+
+#else // pthread backend
+
+#include <stdlib.h>
+
+typedef struct port_queue* port_queue_t;
+typedef struct port_sem* port_sem_t;
+typedef struct port_task* port_task_t;
+
+#define PORT_NO_AFFINITY -1
+
+port_queue_t port_queue_create(unsigned length, size_t item_size);
+bool port_queue_send(port_queue_t queue, const void* item, uint32_t timeout_ms);
+bool port_queue_receive(port_queue_t queue, void* item, uint32_t timeout_ms);
+unsigned port_queue_waiting(port_queue_t queue);
+
+port_sem_t port_mutex_create();
+port_sem_t port_sem_create(unsigned max_count, unsigned initial_count);
+bool port_sem_take(port_sem_t sem, uint32_t timeout_ms);
+void port_sem_give(port_sem_t sem);
+
+/// Start a thread, pinned to core where the host allows it unless PORT_NO_AFFINITY. The priority is ignored.
+bool port_task_create(void (*fn)(void*), const char* name, unsigned stack, void* arg,
+                      unsigned priority, int core, port_task_t* handle);
+int port_num_cores();
+void port_delay_ms(uint32_t ms);
+
+int64_t port_now_us();
+
+static inline void* port_malloc(size_t size) {
+  return malloc(size);
+}
+static inline void* port_calloc(size_t count, size_t size) {
+  return calloc(count, size);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,157 @@
+/** @file
+    Lock-free pool of fixed-size blocks.
+*/
+
+#include "block_pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define BLOCK_POOL_ALIGN 8
+
+static size_t block_pool_aligned(size_t block_size)
+{
+    return (block_size + BLOCK_POOL_ALIGN - 1) & ~(size_t)(BLOCK_POOL_ALIGN - 1);
+}
+
+size_t block_pool_storage_size(unsigned count, size_t block_size)
+{
+    return count * block_pool_aligned(block_size);
+}
+
+int block_pool_init(block_pool_t *pool, void *blocks, unsigned count, size_t block_size)
+{
+    memset(pool, 0, sizeof(*pool));
+    if (!blocks || !count || count > BLOCK_POOL_MAX_BLOCKS)
+        return -1;
+    pool->next = calloc(count, sizeof(*pool->next));
+    if (!pool->next)
+        return -1;
+
+    pool->blocks     = blocks;
+    pool->block_size = block_pool_aligned(block_size);
+    pool->count      = count;
+    for (unsigned i = 0; i < count; ++i)
+        pool->next[i] = i + 1 < count ? i + 1 : BLOCK_POOL_NIL;
+    pool->head = 0;
+    return 0;
+}
+
+void block_pool_free(block_pool_t *pool)
+{
+    free(pool->next);
+    memset(pool, 0, sizeof(*pool));
+}
+
+void block_pool_stats(block_pool_t const *pool, block_pool_stats_t *stats)
+{
+    stats->blocks      = pool->count;
+    stats->in_use      = __atomic_load_n(&pool->in_use, __ATOMIC_RELAXED);
+    stats->peak_in_use = __atomic_load_n(&pool->peak_in_use, __ATOMIC_RELAXED);
+    stats->acquired    = __atomic_load_n(&pool->acquired, __ATOMIC_RELAXED);
+    stats->exhausted   = __atomic_load_n(&pool->exhausted, __ATOMIC_RELAXED);
+}
+
+// Unit testing
+#ifdef _TEST
+#include <stdio.h>
+
+#define ASSERT_EQUALS(a, b) \
+    do { \
+        if ((a) == (b)) \
+            ++passed; \
+        else { \
+            ++failed; \
+            fprintf(stderr, "FAIL: line %d: %u <> %u\n", __LINE__, (unsigned)(a), (unsigned)(b)); \
+        } \
+    } while (0)
+
+#define TEST_BLOCKS 5
+
+int main(void)
+{
+    unsigned passed = 0;
+    unsigned failed = 0;
+    block_pool_t pool;
+    block_pool_stats_t stats;
+    void *blocks[TEST_BLOCKS];
+    static unsigned char storage[TEST_BLOCKS * 16];
+    int foreign;
+
+    fprintf(stderr, "block_pool:: test\n");
+
+    fprintf(stderr, "block_pool:: init checks its arguments and aligns the blocks\n");
+    ASSERT_EQUALS(block_pool_init(&pool, storage, 0, 10), -1);
+    ASSERT_EQUALS(block_pool_init(&pool, NULL, 1, 10), -1);
+    ASSERT_EQUALS(block_pool_init(&pool, storage, BLOCK_POOL_MAX_BLOCKS + 1, 1), -1);
+    ASSERT_EQUALS(block_pool_acquire(&pool) == NULL, 1);
+    ASSERT_EQUALS(block_pool_storage_size(TEST_BLOCKS, 10), sizeof(storage));
+    ASSERT_EQUALS(block_pool_init(&pool, storage, TEST_BLOCKS, 10), 0);
+    ASSERT_EQUALS(pool.block_size, 16);
+
+    fprintf(stderr, "block_pool:: acquire to exhaustion\n");
+    for (unsigned i = 0; i < TEST_BLOCKS; i++) {
+        blocks[i] = block_pool_acquire(&pool);
+        ASSERT_EQUALS(blocks[i] != NULL, 1);
+        ASSERT_EQUALS(block_pool_owns(&pool, blocks[i]), 1);
+        for (unsigned j = 0; j < i; j++)
+            ASSERT_EQUALS(blocks[i] != blocks[j], 1);
+    }
+    ASSERT_EQUALS(block_pool_acquire(&pool) == NULL, 1);
+    ASSERT_EQUALS(block_pool_acquire(&pool) == NULL, 1);
+    block_pool_stats(&pool, &stats);
+    ASSERT_EQUALS(stats.blocks, TEST_BLOCKS);
+    ASSERT_EQUALS(stats.in_use, TEST_BLOCKS);
+    ASSERT_EQUALS(stats.peak_in_use, TEST_BLOCKS);
+    ASSERT_EQUALS(stats.acquired, TEST_BLOCKS);
+    ASSERT_EQUALS(stats.exhausted, 2);
+
+    fprintf(stderr, "block_pool:: released blocks are reused, last in first out\n");
+    block_pool_release(&pool, blocks[3]);
+    block_pool_release(&pool, blocks[1]);
+    ASSERT_EQUALS(block_pool_acquire(&pool) == blocks[1], 1);
+    ASSERT_EQUALS(block_pool_acquire(&pool) == blocks[3], 1);
+    ASSERT_EQUALS(block_pool_acquire(&pool) == NULL, 1);
+    for (unsigned i = 0; i < TEST_BLOCKS; i++)
+        block_pool_release(&pool, blocks[i]);
+    block_pool_stats(&pool, &stats);
+    ASSERT_EQUALS(stats.in_use, 0);
+    ASSERT_EQUALS(stats.peak_in_use, TEST_BLOCKS);
+    ASSERT_EQUALS(stats.acquired, TEST_BLOCKS + 2);
+    for (unsigned i = 0; i < TEST_BLOCKS; i++)
+        ASSERT_EQUALS(block_pool_acquire(&pool) != NULL, 1);
+    ASSERT_EQUALS(block_pool_acquire(&pool) == NULL, 1);
+    for (unsigned i = 0; i < TEST_BLOCKS; i++)
+        block_pool_release(&pool, blocks[i]);
+
+    fprintf(stderr, "block_pool:: foreign pointers are not owned\n");
+    ASSERT_EQUALS(block_pool_owns(&pool, &foreign), 0);
+    ASSERT_EQUALS(block_pool_owns(&pool, storage - 1), 0);
+    ASSERT_EQUALS(block_pool_owns(&pool, storage + sizeof(storage)), 0);
+    ASSERT_EQUALS(block_pool_owns(&pool, storage + sizeof(storage) - 1), 1);
+
+    fprintf(stderr, "block_pool:: every swap changes the tag, the same head index comes back with another tag\n");
+    uint32_t head = pool.head;
+    void *a = block_pool_acquire(&pool);
+    void *b = block_pool_acquire(&pool);
+    block_pool_release(&pool, a);
+    ASSERT_EQUALS(pool.head & 0xffff, head & 0xffff);
+    ASSERT_EQUALS(pool.head >> 16, ((head >> 16) + 3) & 0xffff);
+    uint32_t stale = head;
+    ASSERT_EQUALS(__atomic_compare_exchange_n(&pool.head, &stale, head, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE), 0);
+    block_pool_release(&pool, b);
+
+    fprintf(stderr, "block_pool:: the tag wraps around\n");
+    pool.head = 0xffff0000 | (pool.head & 0xffff);
+    a = block_pool_acquire(&pool);
+    ASSERT_EQUALS(pool.head >> 16, 0);
+    block_pool_release(&pool, a);
+    ASSERT_EQUALS(pool.head >> 16, 1);
+    ASSERT_EQUALS(block_pool_acquire(&pool) == a, 1);
+
+    block_pool_free(&pool);
+
+    fprintf(stderr, "block_pool:: test (%u/%u) passed, (%u) failed.\n", passed, passed + failed, failed);
+
+    return failed;
+}
+#endif /* _TEST */
@@ -10,6 +10,7 @@
 */
 
 #include "decoder_util.h"
+#include "rtl_433.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include "fatal.h"
@@ -43,6 +44,21 @@ void *decoder_user_data(r_device *decoder)
     return decoder->decode_ctx;
 }
 
+int64_t decoder_signal_time_us(r_device *decoder)
+{
+    r_cfg_t const *cfg = decoder->output_ctx; // as set by register_protocol()
+    return cfg ? cfg->signal_us : 0;
+}
+
+unsigned decoder_preamble_search(r_device *decoder, bitbuffer_t *bitbuffer, unsigned row)
+{
+    if (row < decoder->preamble_row)
+        return bitbuffer->bits_per_row[row];
+    if (row == decoder->preamble_row)
+        return decoder->preamble_pos;
+    return bitbuffer_search(bitbuffer, row, 0, decoder->preamble, decoder->preamble_bits);
+}
+
 // output functions
 
 void decoder_output_log(r_device *decoder, int level, data_t *data)
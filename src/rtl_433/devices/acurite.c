@@ -1850,6 +1850,8 @@ r_device const acurite_rain_896 = {
         .gap_limit   = 3500,
         .reset_limit = 5000,
         .decode_fn   = &acurite_rain_896_decode,
+        .min_rows    = 12,
+        .min_bits    = 24,
         .priority    = 10, // Eliminate false positives by letting oregon scientific v1 protocol go earlier
         .fields      = acurite_rain_gauge_output_fields,
 };
@@ -1873,6 +1875,8 @@ r_device const acurite_th = {
         .gap_limit   = 3000,
         .reset_limit = 10000,
         .decode_fn   = &acurite_th_decode,
+        .min_bits    = 40,
+        .max_bits    = 40,
         .fields      = acurite_th_output_fields,
 };
 
@@ -1918,6 +1922,8 @@ r_device const acurite_txr = {
         .gap_limit   = 500,  // longest data gap is 392 us, sync gap is 596 us
         .reset_limit = 4000, // packet gap is 2192 us
         .decode_fn   = &acurite_txr_decode,
+        .min_bits    = 48,
+        .max_bits    = 87,
         .fields      = acurite_txr_output_fields,
 };
 
@@ -1950,6 +1956,8 @@ r_device const acurite_986 = {
         .gap_limit   = 1280,
         .reset_limit = 4000,
         .decode_fn   = &acurite_986_decode,
+        .min_bits    = 39,
+        .max_bits    = 43,
         .fields      = acurite_986_output_fields,
 };
 
@@ -1996,6 +2004,9 @@ r_device const acurite_606 = {
         .gap_limit   = 7000,
         .reset_limit = 10000,
         .decode_fn   = &acurite_606_decode,
+        .min_rows    = 3,
+        .min_bits    = 32,
+        .max_bits    = 33,
         .fields      = acurite_606_output_fields,
 };
 
@@ -2022,6 +2033,8 @@ r_device const acurite_00275rm = {
         .reset_limit = 708, // no packet gap, sync gap is 592 us
         .sync_width  = 632, // sync pulse is 632 us
         .decode_fn   = &acurite_00275rm_decode,
+        .min_bits    = 88,
+        .max_bits    = 88,
         .fields      = acurite_00275rm_output_fields,
 };
 
@@ -2033,5 +2046,8 @@ r_device const acurite_590tx = {
         .gap_limit   = 2000, // (preceeding) sync gap is 3000 us
         .reset_limit = 3500, // no packet gap, gap before sync is 500 us
         .decode_fn   = &acurite_590tx_decode,
+        .min_rows    = 3,
+        .min_bits    = 25,
+        .max_bits    = 25,
         .fields      = acurite_590_output_fields,
 };
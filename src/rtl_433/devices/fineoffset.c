@@ -190,10 +190,11 @@ The WH65B sends the same data with a slightly longer preamble and postamble
  */
 #define MODEL_WH24 24 /* internal identifier for model WH24, family code is always 0x24 */
 #define MODEL_WH65B 65 /* internal identifier for model WH65B, family code is always 0x24 */
+static uint8_t const fineoffset_fsk_preamble[] = {0xAA, 0x2D, 0xD4}; // part of preamble and sync word
+
 static int fineoffset_WH24_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
     data_t *data;
-    uint8_t const preamble[] = {0xAA, 0x2D, 0xD4}; // part of preamble and sync word
     uint8_t b[17]; // aligned packet data
     unsigned bit_offset;
     int type;
@@ -204,7 +205,7 @@ static int fineoffset_WH24_callback(r_device *decoder, bitbuffer_t *bitbuffer)
     }
 
     // Find a data package and extract data buffer
-    bit_offset = bitbuffer_search(bitbuffer, 0, 0, preamble, sizeof(preamble) * 8) + sizeof(preamble) * 8;
+    bit_offset = decoder_preamble_search(decoder, bitbuffer, 0) + sizeof(fineoffset_fsk_preamble) * 8;
     if (bit_offset + sizeof(b) * 8 > bitbuffer->bits_per_row[0]) { // Did not find a big enough package
         decoder_logf_bitbuffer(decoder, 1, __func__, bitbuffer, "Fineoffset_WH24: short package. Header index: %u", bit_offset);
         return DECODE_ABORT_LENGTH;
@@ -383,11 +384,10 @@ FAM:8d ID: 8h 1b Bat_MSB:1d PMTWO:14d Bat_LSB:2d PMTEN:14d CRC:8h BITSIM:8h bbbb
 static int fineoffset_WH0290_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
     data_t *data;
-    uint8_t const preamble[] = {0xAA, 0x2D, 0xD4};
     uint8_t b[8];
     unsigned bit_offset;
 
-    bit_offset = bitbuffer_search(bitbuffer, 0, 0, preamble, sizeof(preamble) * 8) + sizeof(preamble) * 8;
+    bit_offset = decoder_preamble_search(decoder, bitbuffer, 0) + sizeof(fineoffset_fsk_preamble) * 8;
     if (bit_offset + sizeof(b) * 8 > bitbuffer->bits_per_row[0]) {  // Did not find a big enough package
         decoder_logf_bitbuffer(decoder, 1, __func__, bitbuffer, "short package. Row length: %u. Header index: %u", bitbuffer->bits_per_row[0], bit_offset);
         return DECODE_ABORT_LENGTH;
@@ -463,7 +463,6 @@ WH32B is the same as WH25 but two packets in one transmission of {971} and XOR s
 static int fineoffset_WH25_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
     data_t *data;
-    uint8_t const preamble[] = {0xAA, 0x2D, 0xD4};
     uint8_t b[8];
     int type = 25;
     unsigned bit_offset;
@@ -487,7 +486,7 @@ static int fineoffset_WH25_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 
     // Find a data package and extract data payload
     // Nominal index of WH25 is 367, and 123, 570 for WH32B
-    bit_offset = bitbuffer_search(bitbuffer, 0, 0, preamble, sizeof(preamble) * 8) + sizeof(preamble) * 8;
+    bit_offset = decoder_preamble_search(decoder, bitbuffer, 0) + sizeof(fineoffset_fsk_preamble) * 8;
     if (bit_offset + sizeof(b) * 8 > bitbuffer->bits_per_row[0]) {  // Did not find a big enough package
         decoder_logf_bitbuffer(decoder, 1, __func__, bitbuffer, "short package. Header index: %u", bit_offset);
         return DECODE_ABORT_LENGTH;
@@ -594,7 +593,6 @@ Short explanation:
 static int fineoffset_WH51_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
     data_t *data;
-    uint8_t const preamble[] = {0xAA, 0x2D, 0xD4};
     uint8_t b[14];
     unsigned bit_offset;
 
@@ -604,7 +602,7 @@ static int fineoffset_WH51_callback(r_device *decoder, bitbuffer_t *bitbuffer)
     }
 
     // Find a data package and extract data payload
-    bit_offset = bitbuffer_search(bitbuffer, 0, 0, preamble, sizeof(preamble) * 8) + sizeof(preamble) * 8;
+    bit_offset = decoder_preamble_search(decoder, bitbuffer, 0) + sizeof(fineoffset_fsk_preamble) * 8;
     if (bit_offset + sizeof(b) * 8 > bitbuffer->bits_per_row[0]) {  // Did not find a big enough package
         decoder_logf_bitbuffer(decoder, 1, __func__, bitbuffer, "short package. Header index: %u", bit_offset);
         return DECODE_ABORT_LENGTH;
@@ -1016,6 +1014,8 @@ r_device const fineoffset_WH2 = {
         .reset_limit = 1200, // We just want 1 package
         .tolerance   = 160,  // us
         .decode_fn   = &fineoffset_WH2_callback,
+        .min_bits    = 47,
+        .max_bits    = 55,
         .create_fn   = &fineoffset_WH2_create,
         .fields      = output_fields,
 };
@@ -1027,6 +1027,9 @@ r_device const fineoffset_WH25 = {
         .long_width  = 58,    // NRZ encoding (bit width = pulse width)
         .reset_limit = 20000, // Package starts with a huge gap of ~18900 us
         .decode_fn   = &fineoffset_WH25_callback,
+        .min_bits    = 88,
+        .preamble    = fineoffset_fsk_preamble,
+        .preamble_bits = 24,
         .fields      = output_fields_WH25,
 };
 
@@ -1037,6 +1040,9 @@ r_device const fineoffset_WH51 = {
         .long_width  = 58, // NRZ encoding (bit width = pulse width)
         .reset_limit = 5000,
         .decode_fn   = &fineoffset_WH51_callback,
+        .min_bits    = 136,
+        .preamble    = fineoffset_fsk_preamble,
+        .preamble_bits = 24,
         .fields      = output_fields_WH51,
 };
 
@@ -1049,5 +1055,7 @@ r_device const fineoffset_WH0530 = {
         .sync_width  = 0,    // No sync bit used
         .tolerance   = 160,  // us
         .decode_fn   = &fineoffset_WH0530_callback,
+        .min_bits    = 63,
+        .max_bits    = 95,
         .fields      = output_fields_WH0530,
 };
@@ -262,6 +262,8 @@ r_device const fineoffset_wh1050 = {
         .long_width  = 1524,
         .reset_limit = 10520,
         .decode_fn   = &fineoffset_wh1050_callback,
+        .min_rows    = 1,
+        .max_rows    = 1,
         .fields      = output_fields,
 };
 
@@ -272,6 +274,8 @@ r_device const tfa_303151 = {
         .long_width  = 60,
         .reset_limit = 2500,
         .decode_fn   = &fineoffset_wh1050_callback,
+        .min_rows    = 1,
+        .max_rows    = 1,
         .priority    = 10, // Eliminate false positives by letting Fineoffset/Ecowitt WH55 go earlier
         .fields      = output_fields,
 };
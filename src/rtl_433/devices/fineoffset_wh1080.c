@@ -120,6 +120,8 @@ static int const wind_dir_degr[]= {0, 23, 45, 68, 90, 113, 135, 158, 180, 203, 2
 #define TYPE_OOK 1
 #define TYPE_FSK 2
 
+static uint8_t const fineoffset_wh1080_fsk_preamble[] = {0xAA, 0x2D, 0xD4};
+
 static int fineoffset_wh1080_callback(r_device *decoder, bitbuffer_t *bitbuffer, int type)
 {
     data_t *data;
@@ -130,14 +132,13 @@ static int fineoffset_wh1080_callback(r_device *decoder, bitbuffer_t *bitbuffer,
     int preamble;         // 7 or 8 preamble bits
     int temp_raw;
     float temperature;
-    uint8_t const fsk_preamble[] = {0xAA, 0x2D, 0xD4};
 
     if (bitbuffer->num_rows != 1) {
         return DECODE_ABORT_EARLY;
     }
 
     if (type == TYPE_FSK) {
-        int bit_offset = bitbuffer_search(bitbuffer, 0, 0, fsk_preamble, sizeof(fsk_preamble) * 8) + sizeof(fsk_preamble) * 8;
+        int bit_offset = decoder_preamble_search(decoder, bitbuffer, 0) + sizeof(fineoffset_wh1080_fsk_preamble) * 8;
         if (bit_offset + sizeof(bbuf) * 8 > bitbuffer->bits_per_row[0]) {  // Did not find a big enough package
             decoder_logf_bitbuffer(decoder, 1, __func__, bitbuffer, "short package. Header index: %u", bit_offset);
             return DECODE_ABORT_LENGTH;
@@ -356,6 +357,8 @@ r_device const fineoffset_wh1080 = {
         .long_width  = 1524, // Maximum pulse period (long pulse + fixed gap)
         .reset_limit = 2800, // We just want 1 package
         .decode_fn   = &fineoffset_wh1080_callback_ook,
+        .min_rows    = 1,
+        .max_rows    = 1,
         .fields      = output_fields,
 };
 
@@ -366,5 +369,9 @@ r_device const fineoffset_wh1080_fsk = {
         .long_width  = 58,
         .reset_limit = 5800,
         .decode_fn   = &fineoffset_wh1080_callback_fsk,
+        .min_rows    = 1,
+        .max_rows    = 1,
+        .preamble    = fineoffset_wh1080_fsk_preamble,
+        .preamble_bits = 24,
         .fields      = output_fields,
 };
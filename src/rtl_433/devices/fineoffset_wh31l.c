@@ -85,13 +85,14 @@ Raw flex decoder and BitBench format:
 
 #include "decoder.h"
 
+static uint8_t const fineoffset_wh31l_preamble[] = {0xaa, 0x2d, 0xd4}; // (partial) preamble and sync word
+
 static int fineoffset_wh31l_decode(r_device *decoder, bitbuffer_t *bitbuffer)
 {
-    uint8_t const preamble[] = {0xaa, 0x2d, 0xd4}; // (partial) preamble and sync word
 
     int row = 0;
     // Search for preamble and sync-word
-    unsigned start_pos = bitbuffer_search(bitbuffer, row, 0, preamble, 24);
+    unsigned start_pos = decoder_preamble_search(decoder, bitbuffer, row);
     // No preamble detected
     if (start_pos == bitbuffer->bits_per_row[row])
         return DECODE_ABORT_EARLY;
@@ -173,5 +174,8 @@ r_device const fineoffset_wh31l = {
         .long_width  = 56,
         .reset_limit = 1000,
         .decode_fn   = &fineoffset_wh31l_decode,
+        .min_bits    = 24,
+        .preamble    = fineoffset_wh31l_preamble,
+        .preamble_bits = 24,
         .fields      = output_fields,
 };
@@ -43,15 +43,15 @@ Format string:
 
 */
 
+static uint8_t const fineoffset_wh55_preamble[] = {0xAA, 0x2D, 0xD4, 0x55}; // part of preamble, sync word, and message type
+
 static int fineoffset_wh55_decode(r_device *decoder, bitbuffer_t *bitbuffer)
 {
-    uint8_t const preamble[] = {0xAA, 0x2D, 0xD4, 0x55}; // part of preamble, sync word, and message type
-
     if (bitbuffer->num_rows != 1) {
         return DECODE_ABORT_EARLY; // We expect a single row
     }
 
-    unsigned bitpos = bitbuffer_search(bitbuffer, 0, 0, preamble, 32);
+    unsigned bitpos = decoder_preamble_search(decoder, bitbuffer, 0);
     bitpos += 24; // Start at message type
     if (bitpos + 9 * 8 > bitbuffer->bits_per_row[0]) {
         return DECODE_ABORT_EARLY; // No full message found
@@ -115,5 +115,10 @@ r_device const fineoffset_wh55 = {
         .long_width  = 60,
         .reset_limit = 2500,
         .decode_fn   = &fineoffset_wh55_decode,
+        .min_rows    = 1,
+        .max_rows    = 1,
+        .min_bits    = 96,
+        .preamble    = fineoffset_wh55_preamble,
+        .preamble_bits = 32,
         .fields      = output_fields,
 };
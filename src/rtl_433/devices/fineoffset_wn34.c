@@ -37,15 +37,16 @@ Packet layout:
 
 */
 
+static uint8_t const fineoffset_wn34_preamble[] = {0xAA, 0x2D, 0xD4};
+
 static int fineoffset_wn34_decode(r_device *decoder, bitbuffer_t *bitbuffer)
 {
     data_t *data;
-    uint8_t const preamble[] = {0xAA, 0x2D, 0xD4};
     uint8_t b[9];
     unsigned bit_offset;
     float temperature;
 
-    bit_offset = bitbuffer_search(bitbuffer, 0, 0, preamble, sizeof(preamble) * 8) + sizeof(preamble) * 8;
+    bit_offset = decoder_preamble_search(decoder, bitbuffer, 0) + sizeof(fineoffset_wn34_preamble) * 8;
     if (bit_offset + sizeof(b) * 8 > bitbuffer->bits_per_row[0]) {  // Did not find a big enough package
         decoder_logf_bitbuffer(decoder, 2, __func__, bitbuffer, "short package. Row length: %u. Header index: %u", bitbuffer->bits_per_row[0], bit_offset);
         return DECODE_ABORT_LENGTH;
@@ -139,5 +140,8 @@ r_device const fineoffset_wn34 = {
         .long_width  = 58,
         .reset_limit = 2500,
         .decode_fn   = &fineoffset_wn34_decode,
+        .min_bits    = 96,
+        .preamble    = fineoffset_wn34_preamble,
+        .preamble_bits = 24,
         .fields      = output_fields,
 };
@@ -43,9 +43,10 @@ Packet layout:
 
 */
 
+static uint8_t const fineoffset_ws80_preamble[] = {0xaa, 0x2d, 0xd4}; // 24 bit, part of preamble and sync word
+
 static int fineoffset_ws80_decode(r_device *decoder, bitbuffer_t *bitbuffer)
 {
-    uint8_t const preamble[] = {0xaa, 0x2d, 0xd4}; // 24 bit, part of preamble and sync word
     uint8_t b[18];
 
     // Validate package, WS80 nominal size is 219 bit periods
@@ -54,7 +55,7 @@ static int fineoffset_ws80_decode(r_device *decoder, bitbuffer_t *bitbuffer)
     }
 
     // Find a data package and extract data buffer
-    unsigned bit_offset = bitbuffer_search(bitbuffer, 0, 0, preamble, 24) + 24;
+    unsigned bit_offset = decoder_preamble_search(decoder, bitbuffer, 0) + 24;
     if (bit_offset + sizeof(b) * 8 > bitbuffer->bits_per_row[0]) { // Did not find a big enough package
         decoder_logf_bitbuffer(decoder, 2, __func__, bitbuffer, "short package at %u", bit_offset);
         return DECODE_ABORT_LENGTH;
@@ -138,5 +139,9 @@ r_device const fineoffset_ws80 = {
         .long_width  = 58,
         .reset_limit = 1500,
         .decode_fn   = &fineoffset_ws80_decode,
+        .min_bits    = 168,
+        .max_bits    = 240,
+        .preamble    = fineoffset_ws80_preamble,
+        .preamble_bits = 24,
         .fields      = output_fields,
 };
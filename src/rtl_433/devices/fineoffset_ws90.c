@@ -63,9 +63,10 @@ Status 1 will be reset to 0 when:
 
 */
 
+static uint8_t const fineoffset_ws90_preamble[] = {0xaa, 0xaa, 0x2d, 0xd4}; // 32 bit, part of preamble and sync word
+
 static int fineoffset_ws90_decode(r_device *decoder, bitbuffer_t *bitbuffer)
 {
-    uint8_t const preamble[] = {0xaa, 0xaa, 0x2d, 0xd4}; // 32 bit, part of preamble and sync word
     uint8_t b[32];
 
     // Validate package, WS90 nominal size is 345 bit periods
@@ -75,7 +76,7 @@ static int fineoffset_ws90_decode(r_device *decoder, bitbuffer_t *bitbuffer)
     }
 
     // Find a data package and extract data buffer
-    unsigned bit_offset = bitbuffer_search(bitbuffer, 0, 0, preamble, 32) + 32;
+    unsigned bit_offset = decoder_preamble_search(decoder, bitbuffer, 0) + 32;
     if (bit_offset + sizeof(b) * 8 > bitbuffer->bits_per_row[0]) { // Did not find a big enough package
         decoder_logf_bitbuffer(decoder, 2, __func__, bitbuffer, "short package at %u (%u)", bit_offset, bitbuffer->bits_per_row[0]);
         return DECODE_ABORT_LENGTH;
@@ -179,5 +180,9 @@ r_device const fineoffset_ws90 = {
         .long_width  = 58,
         .reset_limit = 3000,
         .decode_fn   = &fineoffset_ws90_decode,
+        .min_bits    = 288,
+        .max_bits    = 500,
+        .preamble    = fineoffset_ws90_preamble,
+        .preamble_bits = 32,
         .fields      = output_fields,
 };
@@ -192,5 +192,7 @@ r_device const lacrossetx = {
         .reset_limit = 8000, // actually: packet gap is 29000 us
         .sync_width  = 0,    // not used
         .decode_fn   = &lacrossetx_decode,
+        .min_bits    = 44,
+        .max_bits    = 44,
         .fields      = output_fields,
 };
@@ -81,9 +81,10 @@ Between -17C and 0C, 'n' is 60.  Below -17C, 'n' is 360.
 
 #include "decoder.h"
 
+static uint8_t const lacrosse_breezepro_preamble[] = {0xd2, 0xaa, 0x2d, 0xd4};
+
 static int lacrosse_breezepro_decode(r_device *decoder, bitbuffer_t *bitbuffer)
 {
-    uint8_t const preamble_pattern[] = {0xd2, 0xaa, 0x2d, 0xd4};
 
     uint8_t b[11];
     uint32_t id;
@@ -96,15 +97,14 @@ static int lacrosse_breezepro_decode(r_device *decoder, bitbuffer_t *bitbuffer)
         return DECODE_ABORT_LENGTH;
     }
 
-    offset = bitbuffer_search(bitbuffer, 0, 0,
-            preamble_pattern, sizeof(preamble_pattern) * 8);
+    offset = decoder_preamble_search(decoder, bitbuffer, 0);
 
     if (offset >= bitbuffer->bits_per_row[0]) {
         decoder_log(decoder, 1, __func__, "Sync word not found");
         return DECODE_ABORT_EARLY;
     }
 
-    offset += sizeof(preamble_pattern) * 8;
+    offset += sizeof(lacrosse_breezepro_preamble) * 8;
     bitbuffer_extract_bytes(bitbuffer, 0, offset, b, 11 * 8);
 
     chk = crc8(b, 11, 0x31, 0x00);
@@ -173,5 +173,8 @@ r_device const lacrosse_breezepro = {
         .long_width  = 107,
         .reset_limit = 5900,
         .decode_fn   = &lacrosse_breezepro_decode,
+        .min_bits    = 264,
+        .preamble    = lacrosse_breezepro_preamble,
+        .preamble_bits = 32,
         .fields      = output_fields,
 };
@@ -63,10 +63,10 @@ Sequence# 0,1,3,4,5 & 7
 
 #include "decoder.h"
 
+static uint8_t const lacrosse_th3_preamble[] = {0xd2, 0xaa, 0x2d, 0xd4};
+
 static int lacrosse_th_decode(r_device *decoder, bitbuffer_t *bitbuffer)
 {
-    uint8_t const preamble_pattern[] = {0xd2, 0xaa, 0x2d, 0xd4};
-
     data_t *data;
     uint8_t b[11];
     uint32_t id;
@@ -89,15 +89,14 @@ static int lacrosse_th_decode(r_device *decoder, bitbuffer_t *bitbuffer)
         model_num = (bitbuffer->bits_per_row[0] < 280) ? 3 : 2;
     }
 
-    offset = bitbuffer_search(bitbuffer, 0, 0,
-            preamble_pattern, sizeof(preamble_pattern) * 8);
+    offset = decoder_preamble_search(decoder, bitbuffer, 0);
 
     if (offset >= bitbuffer->bits_per_row[0]) {
         decoder_log(decoder, 1, __func__, "Sync word not found");
         return DECODE_ABORT_EARLY;
     }
 
-    offset += sizeof(preamble_pattern) * 8;
+    offset += sizeof(lacrosse_th3_preamble) * 8;
     bitbuffer_extract_bytes(bitbuffer, 0, offset, b, 8 * 8);
 
     // failing the CRC checks indicates the packet is corrupt <OR>
@@ -158,5 +157,9 @@ r_device const lacrosse_th3 = {
         .long_width  = 104,
         .reset_limit = 9600,
         .decode_fn   = &lacrosse_th_decode,
+        .min_bits    = 156,
+        .max_bits    = 290,
+        .preamble    = lacrosse_th3_preamble,
+        .preamble_bits = 32,
         .fields      = output_fields,
 };
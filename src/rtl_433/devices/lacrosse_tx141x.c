@@ -313,5 +313,7 @@ r_device const lacrosse_tx141x = {
         .gap_limit   = 625,  // long gap (with short pulse) is ~417 us, sync gap is ~833 us
         .reset_limit = 1700, // maximum gap is 1250 us (long gap + longer sync gap on last repeat)
         .decode_fn   = &lacrosse_tx141x_decode,
+        .min_rows    = 2,
+        .min_bits    = 32,
         .fields      = output_fields,
 };
@@ -75,6 +75,8 @@ These readings have not been tested.
 #define TX31U_MIN_LEN_BYTES    9  // assume at least one measurement
 #define TX31U_MAX_LEN_BYTES    20 // actually shouldn't be more than 18, but we'll be generous
 
+static uint8_t const lacrosse_tx31u_preamble[] = {0xaa, 0xaa, 0x2d, 0xd4}; // preamble + sync word (32 bits)
+
 static int lacrosse_tx31u_decode(r_device *decoder, bitbuffer_t *bitbuffer)
 {
 
@@ -85,8 +87,7 @@ static int lacrosse_tx31u_decode(r_device *decoder, bitbuffer_t *bitbuffer)
     }
 
     // search for expected start sequence
-    uint8_t const start_match[] = {0xaa, 0xaa, 0x2d, 0xd4}; // preamble + sync word (32 bits)
-    unsigned int start_pos      = bitbuffer_search(bitbuffer, 0, 0, start_match, sizeof(start_match) * 8);
+    unsigned int start_pos = decoder_preamble_search(decoder, bitbuffer, 0);
     if (start_pos >= bitbuffer->bits_per_row[0]) {
         return DECODE_ABORT_EARLY;
     }
@@ -211,5 +212,9 @@ r_device const lacrosse_tx31u = {
         .long_width  = 116,
         .reset_limit = 20000,
         .decode_fn   = &lacrosse_tx31u_decode,
+        .max_rows    = 1,
+        .min_bits    = 72,
+        .preamble    = lacrosse_tx31u_preamble,
+        .preamble_bits = 32,
         .fields      = output_fields,
 };
@@ -48,17 +48,17 @@ Could be merged with existing TX29 decoder... or not.
 #define LACROSSE_TX34_PAYLOAD_BITS 40
 #define LACROSSE_TX34_RAIN_FACTOR 0.222f
 
+// 20 bits preamble (shifted left): 1010b 0x2DD4
+static uint8_t const lacrosse_tx34_preamble[] = {0xa2, 0xdd, 0x40};
+
 static int lacrosse_tx34_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
-    // 20 bits preamble (shifted left): 1010b 0x2DD4
-    uint8_t const preamble[] = {0xa2, 0xdd, 0x40};
-
     // process all rows
     int events = 0;
     for (int row = 0; row < bitbuffer->num_rows; ++row) {
 
         // search for preamble
-        unsigned start_pos = bitbuffer_search(bitbuffer, row, 0, preamble, 20) + 20;
+        unsigned start_pos = decoder_preamble_search(decoder, bitbuffer, row) + 20;
         if (start_pos + LACROSSE_TX34_PAYLOAD_BITS > bitbuffer->bits_per_row[row])
             continue; // preamble not found
         decoder_log(decoder, 2, __func__, "LaCrosse IT frame detected");
@@ -121,5 +121,8 @@ r_device const lacrosse_tx34 = {
         .long_width  = 58,
         .reset_limit = 4000,
         .decode_fn   = &lacrosse_tx34_callback,
+        .min_bits    = 60,
+        .preamble    = lacrosse_tx34_preamble,
+        .preamble_bits = 20,
         .fields      = output_fields,
 };
@@ -82,16 +82,16 @@ There's no way to distinguish between the TX35 and TX25U models
 #define LACROSSE_TX29_MODEL          29 // Model number
 #define LACROSSE_TX35_MODEL          35
 
+// 4 bits of preamble, sync word 2dd4, sensor model 9: 24 bit
+static uint8_t const lacrosse_it_preamble[] = {0xa2, 0xdd, 0x49};
+
 static int lacrosse_it(r_device *decoder, bitbuffer_t *bitbuffer, int device29or35)
 {
-    // 4 bits of preamble, sync word 2dd4, sensor model 9: 24 bit
-    uint8_t const preamble[] = {0xa2, 0xdd, 0x49};
-
     int events = 0;
 
     for (int row = 0; row < bitbuffer->num_rows; ++row) {
         // Validate message and reject it as fast as possible : check for preamble
-        unsigned int start_pos = bitbuffer_search(bitbuffer, row, 0, preamble, 24);
+        unsigned int start_pos = decoder_preamble_search(decoder, bitbuffer, row);
         // no preamble detected, move to the next row
         if (start_pos >= bitbuffer->bits_per_row[row])
             continue; // DECODE_ABORT_EARLY
@@ -188,6 +188,9 @@ r_device const lacrosse_tx29 = {
         .long_width  = 55, // 58 us for TX34-IT
         .reset_limit = 4000,
         .decode_fn   = &lacrossetx29_callback,
+        .min_bits    = 24,
+        .preamble    = lacrosse_it_preamble,
+        .preamble_bits = 24,
         .fields      = output_fields,
 };
 
@@ -199,5 +202,8 @@ r_device const lacrosse_tx35 = {
         .long_width  = 105,
         .reset_limit = 4000,
         .decode_fn   = &lacrossetx35_callback,
+        .min_bits    = 24,
+        .preamble    = lacrosse_it_preamble,
+        .preamble_bits = 24,
         .fields      = output_fields,
 };
@@ -50,9 +50,10 @@ LTV-WR1
 
 #include "decoder.h"
 
+static uint8_t const lacrosse_wr1_preamble[] = {0xd2, 0xaa, 0x2d, 0xd4};
+
 static int lacrosse_wr1_decode(r_device *decoder, bitbuffer_t *bitbuffer)
 {
-    uint8_t const preamble_pattern[] = {0xd2, 0xaa, 0x2d, 0xd4};
 
     data_t *data;
     uint8_t b[11];
@@ -72,15 +73,14 @@ static int lacrosse_wr1_decode(r_device *decoder, bitbuffer_t *bitbuffer)
         decoder_logf(decoder, 1, __func__, "packet length: %d", bitbuffer->bits_per_row[0]);
     }
 
-    offset = bitbuffer_search(bitbuffer, 0, 0,
-            preamble_pattern, sizeof(preamble_pattern) * 8);
+    offset = decoder_preamble_search(decoder, bitbuffer, 0);
 
     if (offset >= bitbuffer->bits_per_row[0]) {
         decoder_log(decoder, 1, __func__, "Sync word not found");
         return DECODE_ABORT_EARLY;
     }
 
-    offset += sizeof(preamble_pattern) * 8;
+    offset += sizeof(lacrosse_wr1_preamble) * 8;
     bitbuffer_extract_bytes(bitbuffer, 0, offset, b, 11 * 8);
 
     chk = crc8(b, 11, 0x31, 0x00);
@@ -143,5 +143,9 @@ r_device const lacrosse_wr1 = {
         .long_width  = 104,
         .reset_limit = 9600,
         .decode_fn   = &lacrosse_wr1_decode,
+        .min_bits    = 120,
+        .max_bits    = 156,
+        .preamble    = lacrosse_wr1_preamble,
+        .preamble_bits = 32,
         .fields      = output_fields,
 };
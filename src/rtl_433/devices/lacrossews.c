@@ -221,5 +221,7 @@ r_device const lacrossews = {
         .long_width  = 1464,
         .reset_limit = 8000,
         .decode_fn   = &lacrossews_callback,
+        .min_bits    = 52,
+        .max_bits    = 52,
         .fields      = output_fields,
 };
@@ -13,8 +13,8 @@
 /** @fn int secplus_v1_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 Security+ 1.0 rolling code
 
-@warning This decoder is not stateless.
-@warning This decoder is dependent on elapsed time.
+@warning This decoder is not stateless, each instance keeps the last half message.
+@warning This decoder is dependent on elapsed time, taken from the signal receive time.
 
 Freq 310, 315 and 390 MHz.
 
@@ -23,7 +23,6 @@ Security+ 1.0  is described in [US patent application US6980655B2](https://paten
 */
 
 #include "decoder.h"
-#include "compat_time.h"
 
 /**
 Data comes in two bursts/packets, each bursts/packet is then separately passed to secplus_v1_decode_v1_half.
@@ -134,11 +133,16 @@ static int find_next(bitbuffer_t *bitbuffer, int cur_index)
 // max age for cache in us
 #define CACHE_MAX_AGE 800000
 
-static uint8_t cached_result[24] = {0};
-static struct timeval cached_tv  = {0};
+struct secplus_v1_context {
+    uint8_t cached_result[24];
+    int64_t cached_us; ///< receive time of the cached half
+    int cached;
+};
 
 static int secplus_v1_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
+    struct secplus_v1_context *const context = decoder_user_data(decoder);
+    uint8_t *const cached_result = context->cached_result;
     uint8_t result_1[24] = {0};
     uint8_t result_2[24] = {0};
     int status           = 0;
@@ -205,16 +209,14 @@ static int secplus_v1_callback(r_device *decoder, bitbuffer_t *bitbuffer)
     }
 
     // is there data in cache?
-    if (cached_tv.tv_sec) {
-        struct timeval cur_tv;
-        struct timeval res_tv;
-        gettimeofday(&cur_tv, NULL);
-        timeval_subtract(&res_tv, &cur_tv, &cached_tv);
+    int64_t signal_us = decoder_signal_time_us(decoder);
+    if (context->cached) {
+        int64_t age_us = signal_us - context->cached_us;
 
-        decoder_logf(decoder, 2, __func__, "res %12ld %8ld", (long)res_tv.tv_sec, (long)res_tv.tv_usec);
+        decoder_logf(decoder, 2, __func__, "res %12lld", (long long)age_us);
 
         // is the data not expired
-        if (res_tv.tv_sec == 0 && res_tv.tv_usec < CACHE_MAX_AGE) {
+        if (age_us >= 0 && age_us < CACHE_MAX_AGE) {
 
             // if we have part 2 AND part 1 cached
             if (status == 2 && cached_result[0] == 0) {
@@ -231,19 +233,21 @@ static int secplus_v1_callback(r_device *decoder, bitbuffer_t *bitbuffer)
         }
 
         // clear cache because it is expired or used
-        memset(cached_result, 0, sizeof(cached_result));
-        timerclear(&cached_tv);
+        memset(context->cached_result, 0, sizeof(context->cached_result));
+        context->cached = 0;
 
     } // if cache contains data
 
     if (status == 1) {
-        gettimeofday(&cached_tv, NULL);
+        context->cached_us = signal_us;
+        context->cached    = 1;
         memcpy(cached_result, result_1, 21);
         decoder_log(decoder, 1, __func__, "caching part 1");
         return -2; // found only 1st part
     }
     else if (status == 2) {
-        gettimeofday(&cached_tv, NULL);
+        context->cached_us = signal_us;
+        context->cached    = 1;
         memcpy(cached_result, result_2, 21);
         decoder_log(decoder, 1, __func__, "caching part 2");
         return -2; // found only 2nd part
@@ -400,6 +404,14 @@ static char const *const output_fields[] = {
 //      Freq 310.01M
 //   -X "n=v1,m=OOK_PCM,s=500,l=500,t=40,r=10000,g=7400"
 
+r_device const secplus_v1;
+
+static r_device *secplus_v1_create(char *arg)
+{
+    (void)arg;
+    return decoder_create(&secplus_v1, sizeof(struct secplus_v1_context)); // NOTE: returns NULL on alloc failure.
+}
+
 r_device const secplus_v1 = {
         .name        = "Security+ (Keyfob)",
         .modulation  = OOK_PULSE_PCM,
@@ -409,5 +421,6 @@ r_device const secplus_v1 = {
         .gap_limit   = 15000,
         .reset_limit = 80000,
         .decode_fn   = &secplus_v1_callback,
+        .create_fn   = &secplus_v1_create,
         .fields      = output_fields,
 };
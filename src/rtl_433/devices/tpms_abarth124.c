@@ -83,6 +83,9 @@ static int tpms_abarth124_decode(r_device *decoder, bitbuffer_t *bitbuffer, unsi
 }
 
 /** @sa tpms_abarth124_decode() */
+/// Preamble as sent, the callback inverts the bitbuffer before its own search.
+static uint8_t const tpms_abarth124_preamble[] = {0x55, 0x55, 0x56};
+
 static int tpms_abarth124_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
     // preamble
@@ -122,5 +125,8 @@ r_device const tpms_abarth124 = {
         .long_width  = 52,  // FSK
         .reset_limit = 150, // Maximum gap size before End Of Message [us].
         .decode_fn   = &tpms_abarth124_callback,
+        .min_bits    = 80,
+        .preamble    = tpms_abarth124_preamble,
+        .preamble_bits = 24,
         .fields      = output_fields,
 };
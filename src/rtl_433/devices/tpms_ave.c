@@ -114,9 +114,10 @@ static int tpms_ave_decode(r_device *decoder, bitbuffer_t *bitbuffer, unsigned r
 Wrapper for the AVE tpms.
 @sa tpms_ave_decode()
 */
+static uint8_t const tpms_ave_preamble[] = {0xcc, 0xcc, 0xcc, 0xcd}; // Raw pattern, before differential Manchester coding
+
 static int tpms_ave_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
-    uint8_t const preamble_pattern[] = {0xcc, 0xcc, 0xcc, 0xcd}; // Raw pattern, before differential Manchester coding
 
     int row;
     unsigned bitpos;
@@ -126,7 +127,7 @@ static int tpms_ave_callback(r_device *decoder, bitbuffer_t *bitbuffer)
     for (row = 0; row < bitbuffer->num_rows; ++row) {
         bitpos = 0;
         // Find a preamble with enough bits after it that it could be a complete packet
-        while ((bitpos = bitbuffer_search(bitbuffer, 0, bitpos, preamble_pattern, 32)) + 132 <=
+        while ((bitpos = bitbuffer_search(bitbuffer, 0, bitpos, tpms_ave_preamble, 32)) + 132 <=
                 bitbuffer->bits_per_row[0]) {
             ret = tpms_ave_decode(decoder, bitbuffer, row, bitpos + 32);
             if (ret > 0) {
@@ -161,5 +162,8 @@ r_device const tpms_ave = {
         .reset_limit = 400,
         .tolerance   = 15,
         .decode_fn   = &tpms_ave_callback,
+        .min_bits    = 132,
+        .preamble    = tpms_ave_preamble,
+        .preamble_bits = 32,
         .fields      = output_fields,
 };
@@ -79,12 +79,13 @@ Audi Pressure Alert:
 
 #include "decoder.h"
 
+// preamble is aa59
+static uint8_t const tpms_bmw_preamble[] = {0xaa, 0x59};
+
 static int tpms_bmw_decode(r_device *decoder, bitbuffer_t *bitbuffer)
 {
     bitbuffer_t decoded = { 0 };
     uint8_t *b;
-    // preamble is aa59
-    uint8_t const preamble_pattern[] = {0xaa, 0x59};
     uint8_t len_msg = 11; // default for BMW = 11, if Audi-Alert len_msg = 8
     int flags1      =  0;
     int flags2      =  0;
@@ -97,7 +98,7 @@ static int tpms_bmw_decode(r_device *decoder, bitbuffer_t *bitbuffer)
     }
 
     int pos = 0;
-    pos = bitbuffer_search(bitbuffer, 0, 0, preamble_pattern, sizeof(preamble_pattern) * 8);
+    pos = decoder_preamble_search(decoder, bitbuffer, 0);
     if (pos >= bitbuffer->bits_per_row[0]) {
         decoder_logf(decoder, 2, __func__, "Preamble not found");
         return DECODE_ABORT_EARLY;
@@ -105,7 +106,7 @@ static int tpms_bmw_decode(r_device *decoder, bitbuffer_t *bitbuffer)
 
     decoder_log_bitrow(decoder, 2, __func__, bitbuffer->bb[0], bitbuffer->bits_per_row[0], "MSG");
 
-    bitbuffer_manchester_decode(bitbuffer, 0, pos + sizeof(preamble_pattern) * 8, &decoded, len_msg * 8);
+    bitbuffer_manchester_decode(bitbuffer, 0, pos + sizeof(tpms_bmw_preamble) * 8, &decoded, len_msg * 8);
 
     decoder_log_bitrow(decoder, 2, __func__, decoded.bb[0], decoded.bits_per_row[0], "MC");
 
@@ -190,5 +191,10 @@ r_device const tpms_bmw = {
         .long_width  = 25,
         .reset_limit = 100,
         .decode_fn   = &tpms_bmw_decode,
+        .min_rows    = 1,
+        .max_rows    = 1,
+        .min_bits    = 144,
+        .preamble    = tpms_bmw_preamble,
+        .preamble_bits = 16,
         .fields      = output_fields,
 };
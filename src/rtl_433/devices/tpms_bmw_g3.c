@@ -39,12 +39,13 @@ Data layout{89} 11 x 8:
 
 #include "decoder.h"
 
+// preamble = 0xcccd
+static uint8_t const tpms_bmwg3_preamble[] = {0xcc, 0xcd};
+
 static int tpms_bmwg3_decode(r_device *decoder, bitbuffer_t *bitbuffer)
 {
     bitbuffer_t decoded = { 0 };
     uint8_t *b;
-    // preamble = 0xcccd
-    uint8_t const preamble_pattern[] = {0xcc, 0xcd};
 
     if (bitbuffer->num_rows != 1) {
         decoder_logf(decoder, 2, __func__, "row error");
@@ -52,7 +53,7 @@ static int tpms_bmwg3_decode(r_device *decoder, bitbuffer_t *bitbuffer)
     }
 
     int pos = 0;
-    pos = bitbuffer_search(bitbuffer, 0, 0, preamble_pattern, 16);
+    pos = decoder_preamble_search(decoder, bitbuffer, 0);
     if (pos >= bitbuffer->bits_per_row[0]) {
         decoder_logf(decoder, 1, __func__, "Preamble not found");
         return DECODE_ABORT_EARLY;
@@ -60,7 +61,7 @@ static int tpms_bmwg3_decode(r_device *decoder, bitbuffer_t *bitbuffer)
 
     decoder_log_bitrow(decoder, 1, __func__, bitbuffer->bb[0], bitbuffer->bits_per_row[0], "MSG");
 
-    bitbuffer_differential_manchester_decode(bitbuffer, 0, pos + sizeof(preamble_pattern) * 8, &decoded, 88); // 11 * 8
+    bitbuffer_differential_manchester_decode(bitbuffer, 0, pos + sizeof(tpms_bmwg3_preamble) * 8, &decoded, 88); // 11 * 8
 
     decoder_log_bitrow(decoder, 2, __func__, decoded.bb[0], decoded.bits_per_row[0], "DMC");
 
@@ -128,5 +129,10 @@ r_device const tpms_bmwg3 = {
         .long_width  = 52,
         .reset_limit = 160,
         .decode_fn   = &tpms_bmwg3_decode,
+        .min_rows    = 1,
+        .max_rows    = 1,
+        .min_bits    = 104,
+        .preamble    = tpms_bmwg3_preamble,
+        .preamble_bits = 16,
         .fields      = output_fields,
 };
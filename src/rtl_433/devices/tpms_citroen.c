@@ -93,6 +93,9 @@ static int tpms_citroen_decode(r_device *decoder, bitbuffer_t *bitbuffer, unsign
 }
 
 /** @sa tpms_citroen_decode() */
+/// Preamble as sent, the callback inverts the bitbuffer before its own search.
+static uint8_t const tpms_citroen_preamble[] = {0x55, 0x56};
+
 static int tpms_citroen_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
     // full preamble is 55 55 55 56 (inverted: aa aa aa a9)
@@ -139,5 +142,8 @@ r_device const tpms_citroen = {
         .long_width  = 52,  // FSK
         .reset_limit = 150, // Maximum gap size before End Of Message [us].
         .decode_fn   = &tpms_citroen_callback,
+        .min_bits    = 178,
+        .preamble    = tpms_citroen_preamble,
+        .preamble_bits = 16,
         .fields      = output_fields,
 };
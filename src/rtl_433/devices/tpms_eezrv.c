@@ -166,5 +166,8 @@ r_device const tpms_eezrv = {
         .long_width  = 50,
         .reset_limit = 120,
         .decode_fn   = &tpms_eezrv_decode,
+        .min_rows    = 1,
+        .max_rows    = 1,
+        .min_bits    = 64,
         .fields      = output_fields,
 };
@@ -97,12 +97,13 @@ static int tpms_elantra2012_decode(r_device *decoder, bitbuffer_t *bitbuffer, un
 }
 
 /** @sa tpms_elantra2012_decode() */
+static uint8_t const tpms_elantra2012_preamble[] = {0x71, 0x55}; // 16 bits
+
 static int tpms_elantra2012_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
     // Note that there is a (de)sync preamble of long/short, short/short, triple/triple,
     // i.e. 104 44, 52 48, 144 148 us pulse/gap.
     /* preamble = 111000101010101 0x71 0x55 */
-    uint8_t const preamble_pattern[] = {0x71, 0x55}; // 16 bits
 
     int row;
     unsigned bitpos;
@@ -113,7 +114,7 @@ static int tpms_elantra2012_callback(r_device *decoder, bitbuffer_t *bitbuffer)
         bitpos = 0;
         // Find a preamble with enough bits after it that it could be a complete packet
         while ((bitpos = bitbuffer_search(bitbuffer, row, bitpos,
-                        preamble_pattern, 16)) + 128 <=
+                        tpms_elantra2012_preamble, 16)) + 128 <=
                 bitbuffer->bits_per_row[row]) {
             ret = tpms_elantra2012_decode(decoder, bitbuffer, row, bitpos + 16);
             if (ret > 0)
@@ -146,5 +147,8 @@ r_device const tpms_elantra2012 = {
         .long_width  = 49,  // FSK
         .reset_limit = 200, // Maximum gap size before End Of Message [us].
         .decode_fn   = &tpms_elantra2012_callback,
+        .min_bits    = 128,
+        .preamble    = tpms_elantra2012_preamble,
+        .preamble_bits = 16,
         .fields      = output_fields,
 };
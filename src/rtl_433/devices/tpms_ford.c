@@ -182,6 +182,9 @@ static int tpms_ford_decode(r_device *decoder, bitbuffer_t *bitbuffer, unsigned
 }
 
 /** @sa tpms_ford_decode() */
+/// Preamble as sent, the callback inverts the bitbuffer before its own search.
+static uint8_t const tpms_ford_preamble[] = {0x55, 0x56};
+
 static int tpms_ford_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
     // full preamble is 55 55 55 56 (inverted: aa aa aa a9)
@@ -233,5 +236,8 @@ r_device const tpms_ford = {
         .long_width  = 52,  // FSK
         .reset_limit = 150, // Maximum gap size before End Of Message [us].
         .decode_fn   = &tpms_ford_callback,
+        .min_bits    = 144,
+        .preamble    = tpms_ford_preamble,
+        .preamble_bits = 16,
         .fields      = output_fields,
 };
@@ -141,5 +141,9 @@ r_device const tpms_gm = {
         .long_width  = 0,
         .reset_limit = 15600,
         .decode_fn   = &tpms_gm_decode,
+        .min_rows    = 1,
+        .max_rows    = 1,
+        .min_bits    = 130,
+        .max_bits    = 130,
         .fields      = output_fields,
 };
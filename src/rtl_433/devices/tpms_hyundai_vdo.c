@@ -104,6 +104,9 @@ static int tpms_hyundai_vdo_decode(r_device *decoder, bitbuffer_t *bitbuffer, un
 Wrapper for the Hyundai-VDO tpms.
 @sa tpms_hyundai_vdo_decode()
 */
+/// Preamble as sent, the callback inverts the bitbuffer before its own search.
+static uint8_t const tpms_hyundai_vdo_preamble[] = {0x55, 0x55, 0x55, 0x56};
+
 static int tpms_hyundai_vdo_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
     // full preamble is 55 55 55 56 (inverted: aa aa aa a9)
@@ -148,5 +151,8 @@ r_device const tpms_hyundai_vdo = {
         .long_width  = 52,  // FSK
         .reset_limit = 150, // Maximum gap size before End Of Message [us].
         .decode_fn   = &tpms_hyundai_vdo_callback,
+        .min_bits    = 80,
+        .preamble    = tpms_hyundai_vdo_preamble,
+        .preamble_bits = 32,
         .fields      = output_fields,
 };
@@ -77,6 +77,9 @@ static int tpms_jansite_decode(r_device *decoder, bitbuffer_t *bitbuffer, unsign
 }
 
 /** @sa tpms_jansite_decode() */
+/// Preamble as sent, the callback inverts the bitbuffer before its own search.
+static uint8_t const tpms_jansite_preamble[] = {0x55, 0x55, 0x56};
+
 static int tpms_jansite_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
     // full preamble is
@@ -120,6 +123,9 @@ r_device const tpms_jansite = {
         .long_width  = 52,  // FSK
         .reset_limit = 150, // Maximum gap size before End Of Message [us].
         .decode_fn   = &tpms_jansite_callback,
+        .min_bits    = 80,
+        .preamble    = tpms_jansite_preamble,
+        .preamble_bits = 24,
         .disabled    = 1, // Unknown checksum
         .fields      = output_fields,
 };
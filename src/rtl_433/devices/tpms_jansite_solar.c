@@ -98,15 +98,16 @@ static int tpms_jansite_solar_decode(r_device *decoder, bitbuffer_t *bitbuffer,
 }
 
 /** @sa tpms_jansite_solar_decode() */
+static uint8_t const tpms_jansite_solar_preamble[] = {0xa6, 0xa6, 0x5a};
+
 static int tpms_jansite_solar_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
-    uint8_t const preamble_pattern[3] = {0xa6, 0xa6, 0x5a};
 
     unsigned bitpos = 0;
     int ret         = 0;
     int events      = 0;
 
-    while ((bitpos = bitbuffer_search(bitbuffer, 0, bitpos, preamble_pattern, 24)) + 80 <=
+    while ((bitpos = bitbuffer_search(bitbuffer, 0, bitpos, tpms_jansite_solar_preamble, 24)) + 80 <=
             bitbuffer->bits_per_row[0]) {
 
         ret = tpms_jansite_solar_decode(decoder, bitbuffer, 0, bitpos);
@@ -137,5 +138,8 @@ r_device const tpms_jansite_solar = {
         .long_width  = 51,
         .reset_limit = 5000, // Large enough to merge the 3 duplicate messages
         .decode_fn   = &tpms_jansite_solar_callback,
+        .min_bits    = 80,
+        .preamble    = tpms_jansite_solar_preamble,
+        .preamble_bits = 24,
         .fields      = output_fields,
 };
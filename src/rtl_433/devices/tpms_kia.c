@@ -109,9 +109,10 @@ static int tpms_kia_decode(r_device *decoder, bitbuffer_t *bitbuffer, unsigned r
 Wrapper for the Kia tpms.
 @sa tpms_kia_decode()
 */
+static uint8_t const tpms_kia_preamble[] = {0xed, 0x71};
+
 static int tpms_kia_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
-    uint8_t const preamble_pattern[2] = {0xed, 0x71};
     const int preamble_length         = 16;
 
     unsigned bitpos = 0;
@@ -119,7 +120,7 @@ static int tpms_kia_callback(r_device *decoder, bitbuffer_t *bitbuffer)
     int events      = 0;
 
     // Find a preamble with enough bits after it that it could be a complete packet
-    while ((bitpos = bitbuffer_search(bitbuffer, 0, bitpos, preamble_pattern, preamble_length)) + 154 <= bitbuffer->bits_per_row[0]) {
+    while ((bitpos = bitbuffer_search(bitbuffer, 0, bitpos, tpms_kia_preamble, preamble_length)) + 154 <= bitbuffer->bits_per_row[0]) {
         ret = tpms_kia_decode(decoder, bitbuffer, 0, bitpos + preamble_length);
         if (ret > 0) {
             events += ret;
@@ -150,5 +151,8 @@ r_device const tpms_kia = {
         .long_width  = 50,
         .reset_limit = 200,
         .decode_fn   = &tpms_kia_callback,
+        .min_bits    = 154,
+        .preamble    = tpms_kia_preamble,
+        .preamble_bits = 16,
         .fields      = output_fields,
 };
@@ -72,17 +72,18 @@ static int tpms_nissan_decode(r_device *decoder, bitbuffer_t *bitbuffer, unsigne
 }
 
 /** @sa tpms_nissan_decode() */
+// preamble is f5 55 55 55 e
+static uint8_t const tpms_nissan_preamble[] = {0xf5, 0x55, 0x55, 0x55, 0xe0}; // 36 bits
+
 static int tpms_nissan_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
-    // preamble is f5 55 55 55 e
-    uint8_t const preamble_pattern[5] = {0xf5, 0x55, 0x55, 0x55, 0xe0}; // 36 bits
 
     unsigned bitpos = 0;
     int ret         = 0;
     int events      = 0;
 
     // Find a preamble with enough bits after it that it could be a complete packet
-    while ((bitpos = bitbuffer_search(bitbuffer, 0, bitpos, preamble_pattern, 36)) + 77 <=
+    while ((bitpos = bitbuffer_search(bitbuffer, 0, bitpos, tpms_nissan_preamble, 36)) + 77 <=
             bitbuffer->bits_per_row[0]) {
         ret = tpms_nissan_decode(decoder, bitbuffer, 0, bitpos + 36);
         if (ret > 0)
@@ -110,6 +111,9 @@ r_device const tpms_nissan = {
         .long_width  = 120, // FSK
         .reset_limit = 250, // Maximum gap size before End Of Message [us]. TODO What should this be?
         .decode_fn   = &tpms_nissan_callback,
+        .min_bits    = 77,
+        .preamble    = tpms_nissan_preamble,
+        .preamble_bits = 36,
         .disabled    = 1, // no MIC, disabled by default
         .fields      = output_fields,
 };
@@ -139,5 +139,6 @@ r_device const tpms_pmv107j = {
         .long_width  = 100, // FSK
         .reset_limit = 250, // Maximum gap size before End Of Message [us].
         .decode_fn   = &tpms_pmv107j_callback,
+        .min_bits    = 134,
         .fields      = output_fields,
 };
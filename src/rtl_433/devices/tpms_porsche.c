@@ -84,16 +84,17 @@ static int tpms_porsche_decode(r_device *decoder, bitbuffer_t *bitbuffer, unsign
 }
 
 /** @sa tpms_porsche_decode() */
+// Full preamble is {30}ccccccca (33333332).
+static uint8_t const tpms_porsche_preamble[] = {0x33, 0x33, 0x20}; // 20 bit
+
 static int tpms_porsche_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
-    // Full preamble is {30}ccccccca (33333332).
-    uint8_t const preamble_pattern[] = {0x33, 0x33, 0x20}; // 20 bit
 
     int events = 0;
 
     // Find a preamble with enough bits after it that it could be a complete packet
     unsigned bitpos = 0;
-    while ((bitpos = bitbuffer_search(bitbuffer, 0, bitpos, preamble_pattern, 20)) + 100 <=
+    while ((bitpos = bitbuffer_search(bitbuffer, 0, bitpos, tpms_porsche_preamble, 20)) + 100 <=
             bitbuffer->bits_per_row[0]) {
         events += tpms_porsche_decode(decoder, bitbuffer, 0, bitpos + 20);
         bitpos += 2;
@@ -120,5 +121,8 @@ r_device const tpms_porsche = {
         .long_width  = 52,  // FSK
         .reset_limit = 150, // Maximum gap size before End Of Message [us].
         .decode_fn   = &tpms_porsche_callback,
+        .min_bits    = 100,
+        .preamble    = tpms_porsche_preamble,
+        .preamble_bits = 20,
         .fields      = output_fields,
 };
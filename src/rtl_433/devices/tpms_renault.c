@@ -78,6 +78,9 @@ static int tpms_renault_decode(r_device *decoder, bitbuffer_t *bitbuffer, unsign
 }
 
 /** @sa tpms_renault_decode() */
+/// Preamble as sent, the callback inverts the bitbuffer before its own search.
+static uint8_t const tpms_renault_preamble[] = {0x55, 0x56};
+
 static int tpms_renault_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
     // full preamble is 55 55 55 56 (inverted: aa aa aa a9)
@@ -124,5 +127,8 @@ r_device const tpms_renault = {
         .long_width  = 52,  // FSK
         .reset_limit = 150, // Maximum gap size before End Of Message [us].
         .decode_fn   = &tpms_renault_callback,
+        .min_bits    = 160,
+        .preamble    = tpms_renault_preamble,
+        .preamble_bits = 16,
         .fields      = output_fields,
 };
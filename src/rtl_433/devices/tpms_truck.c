@@ -95,6 +95,9 @@ static int tpms_truck_decode(r_device *decoder, bitbuffer_t *bitbuffer, unsigned
 }
 
 /** @sa tpms_truck_decode() */
+/// Preamble as sent, the callback inverts the bitbuffer before its own search.
+static uint8_t const tpms_truck_preamble[] = {0x55, 0x55, 0x56};
+
 static int tpms_truck_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
     // preamble
@@ -134,5 +137,8 @@ r_device const tpms_truck = {
         .long_width  = 52,
         .reset_limit = 150,
         .decode_fn   = &tpms_truck_callback,
+        .min_bits    = 160,
+        .preamble    = tpms_truck_preamble,
+        .preamble_bits = 24,
         .fields      = output_fields,
 };
@@ -127,10 +127,11 @@ static int tpms_tyreguard400_decode(r_device *decoder, bitbuffer_t *bitbuffer, u
 }
 
 /** @sa tpms_tyreguard400_decode() */
+//uint8_t const tyreguard_frame_sync[] = {0xf, 0xd5, 0xfd, 0x5f}
+static uint8_t const tpms_tyreguard400_preamble[] = {0xfd, 0x5f, 0xd5, 0xf0}; // needs to shift sync to align bytes 28x bits useful
+
 static int tpms_tyreguard400_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
-    //uint8_t const tyreguard_frame_sync[] = {0xf, 0xd5, 0xfd, 0x5f}
-    uint8_t const tyreguard_frame_sync[] = {0xfd, 0x5f, 0xd5, 0xf0}; // needs to shift sync to align bytes 28x bits useful
 
     int ret    = 0;
     int events = 0;
@@ -148,7 +149,7 @@ static int tpms_tyreguard400_callback(r_device *decoder, bitbuffer_t *bitbuffer)
         unsigned bitpos = 0;
 
         // Find a preamble with enough bits after it that it could be a complete packet
-        while ((bitpos = bitbuffer_search(bitbuffer, row, bitpos, tyreguard_frame_sync, 28)) + TPMS_TYREGUARD400_MESSAGE_BITLEN <=
+        while ((bitpos = bitbuffer_search(bitbuffer, row, bitpos, tpms_tyreguard400_preamble, 28)) + TPMS_TYREGUARD400_MESSAGE_BITLEN <=
                 bitbuffer->bits_per_row[row]) {
 
             decoder_logf_bitrow(decoder, 2, __func__, bitbuffer->bb[row], bitbuffer->bits_per_row[row],
@@ -195,5 +196,8 @@ r_device const tpms_tyreguard400 = {
         .gap_limit   = 0,
         .reset_limit = 500,
         .decode_fn   = &tpms_tyreguard400_callback,
+        .min_bits    = 88,
+        .preamble    = tpms_tyreguard400_preamble,
+        .preamble_bits = 28,
         .fields      = output_fields,
 };
@@ -0,0 +1,132 @@
+/** @file
+    Compact pulse and gap width histogram of a pulse train.
+*/
+
+#include "pulse_hist.h"
+#include <string.h>
+
+unsigned pulse_hist_bucket(float width_us)
+{
+    if (width_us <= 0.0f)
+        return 0;
+    if (width_us >= PULSE_HIST_BUCKET_US * (PULSE_HIST_BUCKETS - 1))
+        return PULSE_HIST_BUCKETS - 1;
+    return (unsigned)width_us / PULSE_HIST_BUCKET_US;
+}
+
+void pulse_hist_build(pulse_hist_t *hist, pulse_data_t const *pulses)
+{
+    float to_us = 1e6f / pulses->sample_rate;
+
+    memset(hist, 0, sizeof(*hist));
+    for (unsigned n = 0; n < pulses->num_pulses; ++n) {
+        unsigned p = pulse_hist_bucket(pulses->pulse[n] * to_us);
+        unsigned g = pulse_hist_bucket(pulses->gap[n] * to_us);
+        hist->pulse[p / 32] |= 1u << (p % 32);
+        hist->gap[g / 32] |= 1u << (g % 32);
+    }
+}
+
+int pulse_hist_any(uint32_t const *map, unsigned lo, unsigned hi)
+{
+    if (hi >= PULSE_HIST_BUCKETS)
+        hi = PULSE_HIST_BUCKETS - 1;
+    if (lo > hi)
+        return 0;
+
+    unsigned lo_word = lo / 32;
+    unsigned hi_word = hi / 32;
+    uint32_t lo_mask = ~0u << (lo % 32);
+    uint32_t hi_mask = ~0u >> (31 - hi % 32);
+
+    if (lo_word == hi_word)
+        return (map[lo_word] & lo_mask & hi_mask) != 0;
+    if (map[lo_word] & lo_mask)
+        return 1;
+    for (unsigned w = lo_word + 1; w < hi_word; ++w) {
+        if (map[w])
+            return 1;
+    }
+    return (map[hi_word] & hi_mask) != 0;
+}
+
+/// Logarithmic width class, 1 << PULSE_HIST_LOG_BITS classes per octave.
+static unsigned pulse_hist_log_class(int width)
+{
+    if (width < (1 << PULSE_HIST_LOG_BITS))
+        return width > 0 ? width : 0;
+    unsigned msb = 31 - __builtin_clz((unsigned)width);
+    unsigned sub = (width >> (msb - PULSE_HIST_LOG_BITS)) & ((1 << PULSE_HIST_LOG_BITS) - 1);
+    return msb << PULSE_HIST_LOG_BITS | sub;
+}
+
+/// Smallest width of a logarithmic width class.
+static int pulse_hist_class_width(unsigned cls)
+{
+    unsigned msb = cls >> PULSE_HIST_LOG_BITS;
+    if (msb < PULSE_HIST_LOG_BITS)
+        return cls;
+    unsigned sub = cls & ((1 << PULSE_HIST_LOG_BITS) - 1);
+    return ((1 << PULSE_HIST_LOG_BITS) | sub) << (msb - PULSE_HIST_LOG_BITS);
+}
+
+/// Most frequent logarithmic width classes of the pulses and gaps, the final gap is left out.
+static void pulse_hist_modes(pulse_data_t const *pulses, unsigned *pulse_mode, unsigned *gap_mode)
+{
+    uint16_t pulse_count[32 << PULSE_HIST_LOG_BITS] = {0};
+    uint16_t gap_count[32 << PULSE_HIST_LOG_BITS]   = {0};
+    *pulse_mode = 0;
+    *gap_mode   = 0;
+
+    for (unsigned n = 0; n < pulses->num_pulses; ++n) {
+        unsigned p = pulse_hist_log_class(pulses->pulse[n]);
+        if (++pulse_count[p] > pulse_count[*pulse_mode])
+            *pulse_mode = p;
+        if (n + 1 == pulses->num_pulses)
+            break;
+        unsigned g = pulse_hist_log_class(pulses->gap[n]);
+        if (++gap_count[g] > gap_count[*gap_mode])
+            *gap_mode = g;
+    }
+}
+
+uint32_t pulse_hist_fingerprint(pulse_data_t const *pulses)
+{
+    unsigned pulse_mode;
+    unsigned gap_mode;
+    pulse_hist_modes(pulses, &pulse_mode, &gap_mode);
+
+    unsigned count_bucket = pulses->num_pulses / 16;
+    return (count_bucket & 0xffff) << 16 | (pulse_mode & 0xff) << 8 | (gap_mode & 0xff);
+}
+
+pulse_hist_family_t pulse_hist_classify(pulse_data_t const *pulses)
+{
+    if (pulses->num_pulses < PULSE_HIST_CLASSIFY_MIN_PULSES)
+        return PULSE_HIST_UNKNOWN;
+
+    unsigned pulse_mode;
+    unsigned gap_mode;
+    pulse_hist_modes(pulses, &pulse_mode, &gap_mode);
+
+    float to_us    = 1e6f / pulses->sample_rate;
+    float pulse_us = pulse_hist_class_width(pulse_mode) * to_us;
+    float gap_us   = pulse_hist_class_width(gap_mode) * to_us;
+    float unit_us  = pulse_us < gap_us ? pulse_us : gap_us;
+
+    // FSK mark and space alternate at the bit rate, OOK mostly leaves the carrier off
+    uint64_t mark  = 0;
+    uint64_t space = 0;
+    for (unsigned n = 0; n + 1 < pulses->num_pulses; ++n) {
+        mark += pulses->pulse[n];
+        space += pulses->gap[n];
+    }
+    int balanced = mark * 3 >= space && space * 3 >= mark;
+    int sparse   = space >= mark * 4; // short pulses in long gaps, as in PPM
+
+    if (unit_us < PULSE_HIST_FSK_MAX_UNIT_US && balanced)
+        return PULSE_HIST_FSK;
+    if (unit_us >= PULSE_HIST_OOK_MIN_UNIT_US || sparse)
+        return PULSE_HIST_OOK;
+    return PULSE_HIST_UNKNOWN;
+}
@@ -0,0 +1,199 @@
+/** @file
+    Compact pulse trains, sized to their pulse count.
+*/
+
+#include "pulse_pack.h"
+#include <string.h>
+
+/// Clamp a width to what a pack holds.
+static unsigned pack_width(int width)
+{
+    if (width < 0)
+        return 0;
+    return (unsigned)width > PULSE_PACK_WIDTH_MAX ? PULSE_PACK_WIDTH_MAX : (unsigned)width;
+}
+
+static unsigned width_words(unsigned width)
+{
+    return width < PULSE_PACK_ESCAPE ? 1 : 2;
+}
+
+unsigned pulse_pack_words(pulse_data_t const *data)
+{
+    unsigned words = 0;
+    for (unsigned i = 0; i < data->num_pulses; ++i)
+        words += width_words(pack_width(data->pulse[i])) + width_words(pack_width(data->gap[i]));
+    return words;
+}
+
+static void put_width(pulse_pack_t *pack, unsigned width)
+{
+    if (width < PULSE_PACK_ESCAPE) {
+        pack->widths[pack->num_words++] = width;
+    }
+    else {
+        pack->widths[pack->num_words++] = PULSE_PACK_ESCAPE | width >> 16;
+        pack->widths[pack->num_words++] = width & 0xffff;
+    }
+}
+
+int pulse_pack_encode(pulse_pack_t *pack, unsigned max_words, pulse_data_t const *data)
+{
+    unsigned words = pulse_pack_words(data);
+    if (words > max_words || words > UINT16_MAX)
+        return -1;
+
+    pack->num_pulses     = data->num_pulses;
+    pack->num_words      = 0;
+    pack->signalRssi     = data->signalRssi;
+    pack->signalDuration = data->signalDuration;
+    pack->centerfreq_hz  = data->centerfreq_hz;
+    pack->rssi_db        = data->rssi_db;
+    pack->snr_db         = data->snr_db;
+    pack->noise_db       = data->noise_db;
+    for (unsigned i = 0; i < data->num_pulses; ++i) {
+        put_width(pack, pack_width(data->pulse[i]));
+        put_width(pack, pack_width(data->gap[i]));
+    }
+    return 0;
+}
+
+void pulse_pack_decode(pulse_pack_t const *pack, pulse_data_t *data)
+{
+    // the widths past num_pulses are left as they are, slicers stop at num_pulses
+    memset(data, 0, offsetof(pulse_data_t, pulse));
+    memset(&data->ook_low_estimate, 0, sizeof(*data) - offsetof(pulse_data_t, ook_low_estimate));
+
+    data->sample_rate    = 1000000;
+    data->num_pulses     = pack->num_pulses;
+    data->signalRssi     = pack->signalRssi;
+    data->signalDuration = pack->signalDuration;
+    data->centerfreq_hz  = pack->centerfreq_hz;
+    data->rssi_db        = pack->rssi_db;
+    data->snr_db         = pack->snr_db;
+    data->noise_db       = pack->noise_db;
+    unsigned pos = 0;
+    for (unsigned i = 0; i < pack->num_pulses; ++i) {
+        data->pulse[i] = pulse_pack_next(pack, &pos);
+        data->gap[i]   = pulse_pack_next(pack, &pos);
+    }
+}
+
+// Unit testing
+#ifdef _TEST
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ASSERT_EQUALS(a, b) \
+    do { \
+        if ((a) == (b)) \
+            ++passed; \
+        else { \
+            ++failed; \
+            fprintf(stderr, "FAIL: line %d: %d <> %d\n", __LINE__, (int)(a), (int)(b)); \
+        } \
+    } while (0)
+
+int main(void)
+{
+    unsigned passed = 0;
+    unsigned failed = 0;
+    pulse_data_t *data = calloc(1, sizeof(*data));
+    pulse_data_t *back = calloc(1, sizeof(*back));
+    pulse_pack_t *pack = malloc(pulse_pack_size(4 * PD_MAX_PULSES));
+    if (!data || !back || !pack)
+        return 1;
+
+    fprintf(stderr, "pulse_pack:: test\n");
+
+    fprintf(stderr, "pulse_pack:: round trip of short widths and the signal fields\n");
+    data->num_pulses     = 3;
+    data->pulse[0]       = 1;
+    data->gap[0]         = 0;
+    data->pulse[1]       = 500;
+    data->gap[1]         = 1000;
+    data->pulse[2]       = PULSE_PACK_ESCAPE - 1;
+    data->gap[2]         = 20000;
+    data->signalRssi     = -70;
+    data->centerfreq_hz  = 433.92e6f;
+    ASSERT_EQUALS(pulse_pack_words(data), 6);
+    ASSERT_EQUALS(pulse_pack_encode(pack, 6, data), 0);
+    ASSERT_EQUALS(pack->num_words, 6);
+    back->sample_rate = 250000;
+    back->ook_low_estimate = 1234;
+    pulse_pack_decode(pack, back);
+    ASSERT_EQUALS(back->num_pulses, 3);
+    ASSERT_EQUALS(back->sample_rate, 1000000);
+    ASSERT_EQUALS(back->ook_low_estimate, 0);
+    ASSERT_EQUALS(back->signalRssi, -70);
+    ASSERT_EQUALS(back->centerfreq_hz == 433.92e6f, 1);
+    for (unsigned i = 0; i < data->num_pulses; ++i) {
+        ASSERT_EQUALS(back->pulse[i], data->pulse[i]);
+        ASSERT_EQUALS(back->gap[i], data->gap[i]);
+    }
+
+    fprintf(stderr, "pulse_pack:: widths from 32768 us take the 0x8000 escape\n");
+    data->num_pulses = 4;
+    data->pulse[0]   = PULSE_PACK_ESCAPE;
+    data->gap[0]     = 0xffff;
+    data->pulse[1]   = 0x10000;
+    data->gap[1]     = 0x12345678;
+    data->pulse[2]   = PULSE_PACK_WIDTH_MAX;
+    data->gap[2]     = 100000;
+    data->pulse[3]   = 300;
+    data->gap[3]     = PULSE_PACK_ESCAPE + 1;
+    ASSERT_EQUALS(pulse_pack_words(data), 15);
+    ASSERT_EQUALS(pulse_pack_encode(pack, 15, data), 0);
+    ASSERT_EQUALS(pack->num_words, 15);
+    ASSERT_EQUALS(pack->widths[0], PULSE_PACK_ESCAPE);
+    ASSERT_EQUALS(pack->widths[1], PULSE_PACK_ESCAPE);
+    ASSERT_EQUALS(pack->widths[12], 300);
+    pulse_pack_decode(pack, back);
+    ASSERT_EQUALS(back->num_pulses, 4);
+    for (unsigned i = 0; i < data->num_pulses; ++i) {
+        ASSERT_EQUALS(back->pulse[i], data->pulse[i]);
+        ASSERT_EQUALS(back->gap[i], data->gap[i]);
+    }
+
+    fprintf(stderr, "pulse_pack:: negative widths are clamped to 0\n");
+    data->num_pulses = 2;
+    data->pulse[0]   = -1;
+    data->gap[0]     = -100000;
+    data->pulse[1]   = 400;
+    data->gap[1]     = -2147483647 - 1;
+    ASSERT_EQUALS(pulse_pack_words(data), 4);
+    ASSERT_EQUALS(pulse_pack_encode(pack, 4, data), 0);
+    pulse_pack_decode(pack, back);
+    ASSERT_EQUALS(back->pulse[0], 0);
+    ASSERT_EQUALS(back->gap[0], 0);
+    ASSERT_EQUALS(back->pulse[1], 400);
+    ASSERT_EQUALS(back->gap[1], 0);
+
+    fprintf(stderr, "pulse_pack:: encoding more than max_words fails\n");
+    ASSERT_EQUALS(pulse_pack_encode(pack, 3, data), -1);
+
+    fprintf(stderr, "pulse_pack:: a full train of escaped widths round trips\n");
+    data->num_pulses = PD_MAX_PULSES;
+    for (unsigned i = 0; i < PD_MAX_PULSES; ++i) {
+        data->pulse[i] = i * 40503u % 200000;
+        data->gap[i]   = PULSE_PACK_ESCAPE + i;
+    }
+    unsigned words = pulse_pack_words(data);
+    ASSERT_EQUALS(pulse_pack_encode(pack, words, data), 0);
+    ASSERT_EQUALS(pack->num_words, words);
+    pulse_pack_decode(pack, back);
+    ASSERT_EQUALS(back->num_pulses, PD_MAX_PULSES);
+    unsigned same = 0;
+    for (unsigned i = 0; i < PD_MAX_PULSES; ++i)
+        same += back->pulse[i] == data->pulse[i] && back->gap[i] == data->gap[i];
+    ASSERT_EQUALS(same, PD_MAX_PULSES);
+
+    free(pack);
+    free(back);
+    free(data);
+
+    fprintf(stderr, "pulse_pack:: test (%u/%u) passed, (%u) failed.\n", passed, passed + failed, failed);
+
+    return failed;
+}
+#endif /* _TEST */
@@ -0,0 +1,327 @@
+/** @file
+    Lock-free ring of raw edge timestamps and a packetizer turning it into pulse trains.
+*/
+
+#include "pulse_ring.h"
+#include <stdlib.h>
+#include <string.h>
+
+int pulse_ring_init(pulse_ring_t *ring, unsigned size)
+{
+    unsigned edges = PULSE_RING_MIN_SIZE;
+    while (edges < size)
+        edges <<= 1;
+
+    memset(ring, 0, sizeof(*ring));
+    ring->edges = calloc(edges, sizeof(*ring->edges));
+    if (!ring->edges)
+        return -1;
+    ring->mask = edges - 1;
+    return 0;
+}
+
+void pulse_ring_free(pulse_ring_t *ring)
+{
+    free(ring->edges);
+    memset(ring, 0, sizeof(*ring));
+}
+
+int pulse_ring_pop(pulse_ring_t *ring, pulse_edge_t *edge)
+{
+    uint32_t tail = ring->tail;
+    if (tail == __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE))
+        return 0;
+    *edge = ring->edges[tail & ring->mask];
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+enum {
+    PK_IDLE,
+    PK_PULSE,
+    PK_GAP,
+};
+
+int pulse_packetizer_init(pulse_packetizer_t *pk)
+{
+    memset(pk, 0, sizeof(*pk));
+    pk->data = calloc(1, sizeof(*pk->data));
+    return pk->data ? 0 : -1;
+}
+
+void pulse_packetizer_free(pulse_packetizer_t *pk)
+{
+    free(pk->data);
+    memset(pk, 0, sizeof(*pk));
+}
+
+/// Start a pulse train with the rising edge at time_us.
+static void packetizer_start(pulse_packetizer_t *pk, uint32_t time_us)
+{
+    pk->data->num_pulses = 0;
+    pk->max_pulse        = 0;
+    pk->edge_us          = time_us;
+    pk->state            = PK_PULSE;
+    pk->pending          = 0;
+}
+
+/// Hand out the train if it is long enough, otherwise drop it.
+static pulse_data_t *packetizer_finish(pulse_packetizer_t *pk)
+{
+    if (!pk->pending)
+        pk->state = PK_IDLE;
+    if (pk->data->num_pulses < PD_MIN_PULSES) {
+        pk->short_trains++;
+        return NULL;
+    }
+    pk->data->sample_rate = 1000000;
+    pk->packages++;
+    return pk->data;
+}
+
+/// End Of Package heuristic of pulse_detect, for a gap in microseconds.
+static int packetizer_gap_ends(pulse_packetizer_t const *pk, uint32_t gap_us)
+{
+    return (gap_us > PD_MIN_GAP_MS * 1000 && gap_us > (uint32_t)PD_MAX_GAP_RATIO * pk->max_pulse)
+            || gap_us > PD_MAX_GAP_MS * 1000;
+}
+
+pulse_data_t *pulse_packetizer_run(pulse_packetizer_t *pk, pulse_ring_t *ring, uint32_t now_us)
+{
+    // the train handed out last time is done with, the edge that ended it starts the next one
+    if (pk->pending)
+        packetizer_start(pk, pk->edge_us);
+
+    // edges were lost, whatever is in the ring precedes the loss
+    uint32_t overflows = ring->overflows;
+    if (overflows != pk->overflows) {
+        pk->overflows = overflows;
+        if (pk->state != PK_IDLE)
+            pk->broken_trains++;
+        pk->state = PK_IDLE;
+        __atomic_store_n(&ring->tail, __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+    }
+
+    pulse_data_t *data = pk->data;
+    pulse_edge_t edge;
+    while (pulse_ring_pop(ring, &edge)) {
+        uint32_t width = edge.time_us - pk->edge_us;
+
+        if (pk->state == PK_IDLE) {
+            if (edge.level)
+                packetizer_start(pk, edge.time_us);
+        }
+        else if (pk->state == PK_PULSE && !edge.level) {
+            if (width > PD_MAX_PULSE_MS * 1000) {
+                // not a pulse train, keep what came before the carrier
+                pulse_data_t *done = packetizer_finish(pk);
+                if (done)
+                    return done;
+                continue;
+            }
+            data->pulse[data->num_pulses] = width;
+            if ((int)width > pk->max_pulse)
+                pk->max_pulse = width;
+            pk->edge_us = edge.time_us;
+            pk->state   = PK_GAP;
+        }
+        else if (pk->state == PK_GAP && edge.level) {
+            data->gap[data->num_pulses] = width;
+            data->num_pulses++;
+            pk->edge_us = edge.time_us;
+            pk->state   = PK_PULSE;
+            if (packetizer_gap_ends(pk, width) || data->num_pulses >= PD_MAX_PULSES) {
+                pk->pending = 1;
+                pulse_data_t *done = packetizer_finish(pk);
+                if (done)
+                    return done;
+                packetizer_start(pk, pk->edge_us);
+            }
+        }
+        // a repeated level means an edge was missed by the producer, wait for the next change
+    }
+
+    // no more edges, check the gap or pulse still running, now_us may predate the last edge taken
+    int32_t running = (int32_t)(now_us - pk->edge_us);
+    if (running < 0)
+        running = 0;
+    if (pk->state == PK_GAP && packetizer_gap_ends(pk, running)) {
+        data->gap[data->num_pulses] = running;
+        data->num_pulses++;
+        return packetizer_finish(pk);
+    }
+    if (pk->state == PK_PULSE && (uint32_t)running > PD_MAX_PULSE_MS * 1000)
+        return packetizer_finish(pk);
+    return NULL;
+}
+
+// Unit testing
+#ifdef _TEST
+#include <stdio.h>
+
+#define ASSERT_EQUALS(a, b) \
+    do { \
+        if ((a) == (b)) \
+            ++passed; \
+        else { \
+            ++failed; \
+            fprintf(stderr, "FAIL: line %d: %u <> %u\n", __LINE__, (unsigned)(a), (unsigned)(b)); \
+        } \
+    } while (0)
+
+/// Push a pulse and the falling edge ending it, the gap ends on the next rising edge.
+static void push_pulse(pulse_ring_t *ring, uint32_t *time_us, uint32_t pulse, uint32_t gap)
+{
+    pulse_ring_push(ring, *time_us, 1);
+    *time_us += pulse;
+    pulse_ring_push(ring, *time_us, 0);
+    *time_us += gap;
+}
+
+int main(void)
+{
+    unsigned passed = 0;
+    unsigned failed = 0;
+    pulse_ring_t ring;
+    pulse_packetizer_t pk;
+    pulse_edge_t edge;
+    pulse_data_t *data;
+    uint32_t t;
+
+    fprintf(stderr, "pulse_ring:: test\n");
+
+    fprintf(stderr, "pulse_ring:: size is rounded up to a power of two\n");
+    ASSERT_EQUALS(pulse_ring_init(&ring, 100), 0);
+    ASSERT_EQUALS(ring.mask, 127);
+    pulse_ring_free(&ring);
+    ASSERT_EQUALS(pulse_ring_init(&ring, 1), 0);
+    ASSERT_EQUALS(ring.mask, PULSE_RING_MIN_SIZE - 1);
+
+    fprintf(stderr, "pulse_ring:: wrap-around of the slots, the indexes and the timestamps\n");
+    ring.head = ring.tail = 0xfffffff0;
+    unsigned popped = 0;
+    for (unsigned i = 0; i < 300; i++) {
+        pulse_ring_push(&ring, 0xffffff00 + i * 7, i & 1);
+        if (i % 3 == 2) {
+            while (pulse_ring_pop(&ring, &edge)) {
+                ASSERT_EQUALS(edge.time_us, 0xffffff00 + popped * 7);
+                ASSERT_EQUALS(edge.level, popped & 1);
+                popped++;
+            }
+        }
+    }
+    ASSERT_EQUALS(popped, 300);
+    ASSERT_EQUALS(ring.overflows, 0);
+    ASSERT_EQUALS(pulse_ring_pop(&ring, &edge), 0);
+
+    fprintf(stderr, "pulse_ring:: overflow drops the newest edges\n");
+    for (unsigned i = 0; i < PULSE_RING_MIN_SIZE + 3; i++)
+        pulse_ring_push(&ring, i, 1);
+    ASSERT_EQUALS(ring.overflows, 3);
+    for (popped = 0; pulse_ring_pop(&ring, &edge); popped++)
+        ASSERT_EQUALS(edge.time_us, popped);
+    ASSERT_EQUALS(popped, PULSE_RING_MIN_SIZE);
+    pulse_ring_free(&ring);
+
+    ASSERT_EQUALS(pulse_ring_init(&ring, 4 * PD_MAX_PULSES), 0);
+    ASSERT_EQUALS(pulse_packetizer_init(&pk), 0);
+
+    fprintf(stderr, "pulse_packetizer:: a gap over PD_MIN_GAP_MS and the ratio ends the train\n");
+    t = 0xfffff000; // the timestamps wrap inside the train
+    for (unsigned i = 0; i < 20; i++)
+        push_pulse(&ring, &t, 500, i == 19 ? PD_MIN_GAP_MS * 1000 + 1 : 1000);
+    pulse_ring_push(&ring, t, 1);
+    data = pulse_packetizer_run(&pk, &ring, t);
+    ASSERT_EQUALS(data != NULL, 1);
+    if (data) {
+        ASSERT_EQUALS(data->num_pulses, 20);
+        ASSERT_EQUALS(data->pulse[0], 500);
+        ASSERT_EQUALS(data->gap[0], 1000);
+        ASSERT_EQUALS(data->gap[19], PD_MIN_GAP_MS * 1000 + 1);
+        ASSERT_EQUALS(data->sample_rate, 1000000);
+    }
+
+    fprintf(stderr, "pulse_packetizer:: a gap under the ratio keeps the train, the next one starts on the ending edge\n");
+    t += 2000;
+    pulse_ring_push(&ring, t, 0); // first pulse of the train started above
+    t += 1000;
+    for (unsigned i = 0; i < 19; i++)
+        push_pulse(&ring, &t, 2000, i == 9 ? PD_MIN_GAP_MS * 1000 + 1 : 1000);
+    data = pulse_packetizer_run(&pk, &ring, t);
+    ASSERT_EQUALS(data == NULL, 1);
+
+    fprintf(stderr, "pulse_packetizer:: a gap over PD_MAX_GAP_MS ends the train whatever the ratio, also while running\n");
+    data = pulse_packetizer_run(&pk, &ring, t - 1000 + PD_MAX_GAP_MS * 1000 + 1);
+    ASSERT_EQUALS(data != NULL, 1);
+    if (data) {
+        ASSERT_EQUALS(data->num_pulses, 20);
+        ASSERT_EQUALS(data->pulse[0], 2000);
+        ASSERT_EQUALS(data->gap[10], PD_MIN_GAP_MS * 1000 + 1);
+        ASSERT_EQUALS(data->gap[19], PD_MAX_GAP_MS * 1000 + 1);
+    }
+    ASSERT_EQUALS(pk.packages, 2);
+
+    fprintf(stderr, "pulse_packetizer:: trains under PD_MIN_PULSES are dropped\n");
+    t += PD_MAX_GAP_MS * 1000;
+    for (unsigned i = 0; i < PD_MIN_PULSES - 2; i++)
+        push_pulse(&ring, &t, 500, 1000);
+    pulse_ring_push(&ring, t, 1);
+    t += 500;
+    pulse_ring_push(&ring, t, 0);
+    data = pulse_packetizer_run(&pk, &ring, t + PD_MAX_GAP_MS * 1000 + 1);
+    ASSERT_EQUALS(data == NULL, 1);
+    ASSERT_EQUALS(pk.short_trains, 1);
+
+    fprintf(stderr, "pulse_packetizer:: a pulse over PD_MAX_PULSE_MS ends the train before it\n");
+    t += 2 * PD_MAX_GAP_MS * 1000;
+    for (unsigned i = 0; i < 20; i++)
+        push_pulse(&ring, &t, 500, 1000);
+    push_pulse(&ring, &t, PD_MAX_PULSE_MS * 1000 + 1, 1000);
+    data = pulse_packetizer_run(&pk, &ring, t);
+    ASSERT_EQUALS(data != NULL, 1);
+    if (data) {
+        ASSERT_EQUALS(data->num_pulses, 20);
+        ASSERT_EQUALS(data->pulse[19], 500);
+    }
+
+    fprintf(stderr, "pulse_packetizer:: PD_MAX_PULSES splits a train without losing pulses\n");
+    t += PD_MAX_GAP_MS * 1000;
+    for (unsigned i = 0; i < PD_MAX_PULSES + 30; i++)
+        push_pulse(&ring, &t, 300 + i % 7, 600);
+    pulse_ring_push(&ring, t, 1);
+    data = pulse_packetizer_run(&pk, &ring, t);
+    ASSERT_EQUALS(data != NULL, 1);
+    if (data) {
+        ASSERT_EQUALS(data->num_pulses, PD_MAX_PULSES);
+        ASSERT_EQUALS(data->pulse[PD_MAX_PULSES - 1], 300 + (PD_MAX_PULSES - 1) % 7);
+    }
+    data = pulse_packetizer_run(&pk, &ring, t + PD_MAX_GAP_MS * 1000 + 1);
+    ASSERT_EQUALS(data != NULL, 1);
+    if (data) {
+        ASSERT_EQUALS(data->num_pulses, 30);
+        ASSERT_EQUALS(data->pulse[0], 300 + PD_MAX_PULSES % 7);
+    }
+
+    fprintf(stderr, "pulse_packetizer:: a train spanning a ring overflow is dropped\n");
+    t += 2 * PD_MAX_GAP_MS * 1000;
+    unsigned broken = pk.broken_trains;
+    for (unsigned i = 0; i < 10; i++)
+        push_pulse(&ring, &t, 500, 1000);
+    data = pulse_packetizer_run(&pk, &ring, t);
+    ASSERT_EQUALS(data == NULL, 1);
+    for (unsigned i = 0; i <= ring.mask + 1; i++)
+        pulse_ring_push(&ring, t + i, i & 1);
+    ASSERT_EQUALS(ring.overflows > 0, 1);
+    data = pulse_packetizer_run(&pk, &ring, t);
+    ASSERT_EQUALS(data == NULL, 1);
+    ASSERT_EQUALS(pk.broken_trains, broken + 1);
+    ASSERT_EQUALS(pulse_ring_pop(&ring, &edge), 0);
+
+    pulse_packetizer_free(&pk);
+    pulse_ring_free(&ring);
+
+    fprintf(stderr, "pulse_ring:: test (%u/%u) passed, (%u) failed.\n", passed, passed + failed, failed);
+
+    return failed;
+}
+#endif /* _TEST */
@@ -17,14 +17,40 @@
 #include "c_util.h" // for MIN()
 #include "logger.h"
 #include "decoder_util.h" // TODO: this should be refactored
+#include "r_private.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <math.h>
 #include <limits.h>
-bitbuffer_t bits;
+#include <string.h>
+#include <time.h>
 
-static int account_event(r_device *device, bitbuffer_t *bits, char const *demod_name)
+/// Copy the used rows of a sliced bitbuffer into a view, clearing rows the view used beyond them.
+static void bitbuffer_copy_view(bitbuffer_t *view, bitbuffer_t const *bits)
+{
+    unsigned src_rows  = MAX(bits->num_rows, bits->free_row);
+    unsigned view_rows = MAX(view->num_rows, view->free_row);
+    src_rows  = MIN(src_rows, BITBUF_ROWS);
+    view_rows = MIN(view_rows, BITBUF_ROWS);
+
+    view->num_rows = bits->num_rows;
+    view->free_row = bits->free_row;
+    memcpy(view->bits_per_row, bits->bits_per_row, sizeof(view->bits_per_row));
+    memcpy(view->syncs_before_row, bits->syncs_before_row, sizeof(view->syncs_before_row));
+    memcpy(view->bb, bits->bb, src_rows * sizeof(*bits->bb));
+    if (view_rows > src_rows) {
+        memset(view->bb[src_rows], 0, (view_rows - src_rows) * sizeof(*bits->bb));
+    }
+}
+
+/// Add to a counter only this task writes, as an atomic store since readers on other tasks load it.
+static inline void stats_add(unsigned *counter, unsigned n)
+{
+    __atomic_store_n(counter, *counter + n, __ATOMIC_RELAXED);
+}
+
+static int account_decoder(r_device *device, bitbuffer_t *bits, char const *demod_name)
 {
     // run decoder
     int ret = 0;
@@ -32,20 +58,24 @@ static int account_event(r_device *device, bitbuffer_t *bits, char const *demod_
         ret = device->decode_fn(device, bits);
     }
 
-    // statistics accounting
-    device->decode_events += 1;
+    // statistics accounting, bracketed by an odd stats_seq for readers on other tasks
+    unsigned seq = device->stats_seq;
+    __atomic_store_n(&device->stats_seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    stats_add(&device->decode_events, 1);
     if (ret > 0) {
-        device->decode_ok += 1;
-        device->decode_messages += ret;
+        stats_add(&device->decode_ok, 1);
+        stats_add(&device->decode_messages, ret);
     }
     else if (ret >= DECODE_FAIL_SANITY) {
-        device->decode_fails[-ret] += 1;
+        stats_add(&device->decode_fails[-ret], 1);
         ret = 0;
     }
     else {
         print_logf(LOG_ERROR, demod_name, "Decoder \"%s\" gave invalid return value %d: notify maintainer", device->name, ret);
         exit(1);
     }
+    __atomic_store_n(&device->stats_seq, seq + 2, __ATOMIC_RELEASE);
 
     // Find longest row
     unsigned max_bits = 0;
@@ -63,8 +93,163 @@ static int account_event(r_device *device, bitbuffer_t *bits, char const *demod_
     return ret;
 }
 
-int pulse_slicer_pcm(pulse_data_t const *pulses, r_device *device)
+#define PREAMBLE_CACHE_SIZE 8
+
+/// Search results for the preambles declared by the devices of one slice group.
+typedef struct preamble_cache {
+    struct {
+        uint8_t const *preamble;
+        unsigned preamble_bits;
+        unsigned row;
+        unsigned pos;
+    } hits[PREAMBLE_CACHE_SIZE];
+    unsigned num_hits;
+} preamble_cache_t;
+
+/// Locate the declared preamble of a device in a slice, sharing searches for identical patterns.
+static int account_preamble(r_device *device, bitbuffer_t *bits, preamble_cache_t *cache)
 {
+    unsigned bytes = (device->preamble_bits + 7) / 8;
+    unsigned i;
+    for (i = 0; i < cache->num_hits; ++i) {
+        if (cache->hits[i].preamble_bits == device->preamble_bits
+                && (cache->hits[i].preamble == device->preamble
+                        || !memcmp(cache->hits[i].preamble, device->preamble, bytes)))
+            break;
+    }
+
+    unsigned row = 0;
+    unsigned pos = 0;
+    if (i < cache->num_hits) {
+        row = cache->hits[i].row;
+        pos = cache->hits[i].pos;
+    }
+    else {
+        for (; row < bits->num_rows; ++row) {
+            pos = bitbuffer_search(bits, row, 0, device->preamble, device->preamble_bits);
+            if (pos < bits->bits_per_row[row])
+                break;
+        }
+        if (cache->num_hits < PREAMBLE_CACHE_SIZE) {
+            cache->hits[cache->num_hits].preamble      = device->preamble;
+            cache->hits[cache->num_hits].preamble_bits = device->preamble_bits;
+            cache->hits[cache->num_hits].row           = row;
+            cache->hits[cache->num_hits].pos           = pos;
+            cache->num_hits += 1;
+        }
+    }
+
+    device->preamble_row = row;
+    device->preamble_pos = pos;
+    return row < bits->num_rows;
+}
+
+/// Dispatcher state of a device, NULL when sliced without the dispatcher.
+static dispatch_dev_t *account_state(pulse_slicer_ctx_t *ctx, r_device const *device)
+{
+    return ctx->devs ? &ctx->devs[device->protocol_num] : NULL;
+}
+
+/// Check the declared row count, row length and preamble limits of a device against a slice,
+/// devices the dispatcher left out of the current signal are never accepted.
+static int account_accepts(pulse_slicer_ctx_t *ctx, r_device *device, bitbuffer_t *bits, preamble_cache_t *cache)
+{
+    dispatch_dev_t const *state = account_state(ctx, device);
+    if (state && state->dispatch_skip)
+        return 0;
+    if (device->min_rows && bits->num_rows < device->min_rows)
+        return 0;
+    if (device->max_rows && bits->num_rows > device->max_rows)
+        return 0;
+
+    if (device->min_bits || device->max_bits) {
+        unsigned max_bits = device->max_bits ? device->max_bits : UINT_MAX;
+        int row = 0;
+        for (; row < bits->num_rows; ++row) {
+            if (bits->bits_per_row[row] >= device->min_bits && bits->bits_per_row[row] <= max_bits)
+                break;
+        }
+        if (row == bits->num_rows)
+            return 0;
+    }
+
+    if (device->preamble && device->preamble_bits)
+        return account_preamble(device, bits, cache);
+    return 1;
+}
+
+/// Next device sharing the slice of a device.
+static r_device *account_slice_next(pulse_slicer_ctx_t *ctx, r_device const *device)
+{
+    dispatch_dev_t const *state = account_state(ctx, device);
+    return state ? state->slice_next : NULL;
+}
+
+/// Find the next device, starting with the given one, whose limits accept a slice.
+static r_device *account_next(pulse_slicer_ctx_t *ctx, r_device *device, bitbuffer_t *bits, preamble_cache_t *cache)
+{
+    while (device && !account_accepts(ctx, device, bits, cache))
+        device = account_slice_next(ctx, device);
+    return device;
+}
+
+/// Weight of a new sample in the decode time average is 1 / (1 << DECODE_COST_SHIFT).
+#define DECODE_COST_SHIFT 3
+
+static uint64_t account_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/// Run a decoder and fold its execution time into the decode time average of the device.
+static int account_timed(dispatch_dev_t *state, r_device *device, bitbuffer_t *bits, char const *demod_name)
+{
+    uint64_t start = account_now_ns();
+    int ret = account_decoder(device, bits, demod_name);
+    uint64_t elapsed = account_now_ns() - start;
+
+    unsigned cost = elapsed < UINT_MAX ? (unsigned)elapsed : UINT_MAX;
+    if (!cost)
+        cost = 1;
+    unsigned avg = state->cost_ns;
+    if (avg)
+        cost = avg - (avg >> DECODE_COST_SHIFT) + (cost >> DECODE_COST_SHIFT);
+    __atomic_store_n(&state->cost_ns, cost ? cost : 1, __ATOMIC_RELAXED); // read by save_dispatch_model()
+    return ret;
+}
+
+static int account_event(pulse_slicer_ctx_t *ctx, r_device *device, bitbuffer_t *bits, char const *demod_name)
+{
+    int ret = 0;
+    preamble_cache_t cache = {0};
+    // Devices sharing this slice decode a private view as decoders may modify the bitbuffer,
+    // the last one gets the slice itself since it is cleared afterwards anyway.
+    // Devices whose limits reject the slice are skipped without any accounting.
+    // All limits are checked before a device decodes, i.e. on the unmodified slice.
+    device = account_next(ctx, device, bits, &cache);
+    while (device) {
+        r_device *next = account_next(ctx, account_slice_next(ctx, device), bits, &cache);
+        bitbuffer_t *slice = bits;
+        if (next) {
+            bitbuffer_copy_view(&ctx->bits_view, bits);
+            slice = &ctx->bits_view;
+        }
+        // two clock reads per decoder only pay off when ordering by hits per cost
+        if (ctx->timed && ctx->devs)
+            ret += account_timed(account_state(ctx, device), device, slice, demod_name);
+        else
+            ret += account_decoder(device, slice, demod_name);
+        device = next;
+    }
+
+    return ret;
+}
+
+int pulse_slicer_pcm(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device *device)
+{
+    bitbuffer_t *bits = &ctx->bits;
     float samples_per_us = pulses->sample_rate / 1.0e6f;
     int s_short = device->short_width * samples_per_us;
     int s_long  = device->long_width * samples_per_us;
@@ -89,7 +274,7 @@ int pulse_slicer_pcm(pulse_data_t const *pulses, r_device *device)
     float f_long  = device->long_width > 0.0f ? 1.0f / (device->long_width * samples_per_us) : 0;
 
     int events = 0;
-    bitbuffer_clear(&bits);
+    bitbuffer_clear(bits);
 
     int const gap_limit = s_gap ? s_gap : s_reset;
     int const max_zeros = gap_limit / s_long;
@@ -220,12 +405,12 @@ int pulse_slicer_pcm(pulse_data_t const *pulses, r_device *device)
 
         // Add run of ones (1 for RZ, many for NRZ)
         for (int i = 0; i < highs; ++i) {
-            bitbuffer_add_bit(&bits, 1);
+            bitbuffer_add_bit(bits, 1);
         }
         // Add run of zeros, handle possibly negative "lows" gracefully
         lows = MIN(lows, max_zeros); // Don't overflow at end of message
         for (int i = 0; i < lows; ++i) {
-            bitbuffer_add_bit(&bits, 0);
+            bitbuffer_add_bit(bits, 0);
         }
 
         // Validate data
@@ -238,27 +423,28 @@ int pulse_slicer_pcm(pulse_data_t const *pulses, r_device *device)
                         n, pulses->pulse[n], pulses->gap[n],
                         pulses->pulse[n] + pulses->gap[n]);
             }
-            bitbuffer_clear(&bits);
+            bitbuffer_clear(bits);
         }
 
         // Check for new packet in multipacket
         else if (pulses->gap[n] > gap_limit && pulses->gap[n] <= s_reset) {
-            bitbuffer_add_row(&bits);
+            bitbuffer_add_row(bits);
         }
         // End of Message?
         if (((n == pulses->num_pulses - 1)                            // No more pulses? (FSK)
                     || (pulses->gap[n] > s_reset))      // Long silence (OOK)
-                && (bits.bits_per_row[0] > 0 || bits.num_rows > 1)) { // Only if data has been accumulated
+                && (bits->bits_per_row[0] > 0 || bits->num_rows > 1)) { // Only if data has been accumulated
 
-            events += account_event(device, &bits, __func__);
-            bitbuffer_clear(&bits);
+            events += account_event(ctx, device, bits, __func__);
+            bitbuffer_clear(bits);
         }
     } // for
     return events;
 }
 
-int pulse_slicer_ppm(pulse_data_t const *pulses, r_device *device)
+int pulse_slicer_ppm(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device *device)
 {
+    bitbuffer_t *bits = &ctx->bits;
     float samples_per_us = pulses->sample_rate / 1.0e6f;
 
     int s_short = device->short_width * samples_per_us;
@@ -280,7 +466,7 @@ int pulse_slicer_ppm(pulse_data_t const *pulses, r_device *device)
     }
 
     int events = 0;
-    bitbuffer_clear(&bits);
+    bitbuffer_clear(bits);
 
     // lower and upper bounds (non inclusive)
     int zero_l, zero_u;
@@ -309,35 +495,36 @@ int pulse_slicer_ppm(pulse_data_t const *pulses, r_device *device)
     for (unsigned n = 0; n < pulses->num_pulses; ++n) {
         if (pulses->gap[n] > zero_l && pulses->gap[n] < zero_u) {
             // Short gap
-            bitbuffer_add_bit(&bits, 0);
+            bitbuffer_add_bit(bits, 0);
         }
         else if (pulses->gap[n] > one_l && pulses->gap[n] < one_u) {
             // Long gap
-            bitbuffer_add_bit(&bits, 1);
+            bitbuffer_add_bit(bits, 1);
         }
         else if (pulses->gap[n] > sync_l && pulses->gap[n] < sync_u) {
             // Sync gap
-            bitbuffer_add_sync(&bits);
+            bitbuffer_add_sync(bits);
         }
 
         // Check for new packet in multipacket
         else if (pulses->gap[n] < s_reset) {
-            bitbuffer_add_row(&bits);
+            bitbuffer_add_row(bits);
         }
         // End of Message?
         if (((n == pulses->num_pulses - 1)                            // No more pulses? (FSK)
                     || (pulses->gap[n] >= s_reset))     // Long silence (OOK)
-                && (bits.bits_per_row[0] > 0 || bits.num_rows > 1)) { // Only if data has been accumulated
+                && (bits->bits_per_row[0] > 0 || bits->num_rows > 1)) { // Only if data has been accumulated
 
-            events += account_event(device, &bits, __func__);
-            bitbuffer_clear(&bits);
+            events += account_event(ctx, device, bits, __func__);
+            bitbuffer_clear(bits);
         }
     } // for pulses
     return events;
 }
 
-int pulse_slicer_pwm(pulse_data_t const *pulses, r_device *device)
+int pulse_slicer_pwm(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device *device)
 {
+    bitbuffer_t *bits = &ctx->bits;
     float samples_per_us = pulses->sample_rate / 1.0e6f;
 
     int s_short = device->short_width * samples_per_us;
@@ -359,7 +546,7 @@ int pulse_slicer_pwm(pulse_data_t const *pulses, r_device *device)
     }
 
     int events = 0;
-    bitbuffer_clear(&bits);
+    bitbuffer_clear(bits);
 
     // lower and upper bounds (non inclusive)
     int one_l, one_u;
@@ -415,42 +602,43 @@ int pulse_slicer_pwm(pulse_data_t const *pulses, r_device *device)
     for (unsigned n = 0; n < pulses->num_pulses; ++n) {
         if (pulses->pulse[n] > one_l && pulses->pulse[n] < one_u) {
             // 'Short' 1 pulse
-            bitbuffer_add_bit(&bits, 1);
+            bitbuffer_add_bit(bits, 1);
         }
         else if (pulses->pulse[n] > zero_l && pulses->pulse[n] < zero_u) {
             // 'Long' 0 pulse
-            bitbuffer_add_bit(&bits, 0);
+            bitbuffer_add_bit(bits, 0);
         }
         else if (pulses->pulse[n] > sync_l && pulses->pulse[n] < sync_u) {
             // Sync pulse
-            bitbuffer_add_sync(&bits);
+            bitbuffer_add_sync(bits);
         }
         else if (pulses->pulse[n] <= one_l) {
             // Ignore spurious short pulses
         }
         else {
             // Pulse outside specified timing
-            bitbuffer_add_row(&bits);
+            bitbuffer_add_row(bits);
         }
 
         // End of Message?
         if (((n == pulses->num_pulses - 1)                       // No more pulses? (FSK)
                     || (pulses->gap[n] > s_reset)) // Long silence (OOK)
-                && (bits.num_rows > 0)) {                        // Only if data has been accumulated
-            events += account_event(device, &bits, __func__);
-            bitbuffer_clear(&bits);
+                && (bits->num_rows > 0)) {                        // Only if data has been accumulated
+            events += account_event(ctx, device, bits, __func__);
+            bitbuffer_clear(bits);
         }
         else if (s_gap > 0 && pulses->gap[n] > s_gap
-                && bits.num_rows > 0 && bits.bits_per_row[bits.num_rows - 1] > 0) {
+                && bits->num_rows > 0 && bits->bits_per_row[bits->num_rows - 1] > 0) {
             // New packet in multipacket
-            bitbuffer_add_row(&bits);
+            bitbuffer_add_row(bits);
         }
     }
     return events;
 }
 
-int pulse_slicer_manchester_zerobit(pulse_data_t const *pulses, r_device *device)
+int pulse_slicer_manchester_zerobit(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device *device)
 {
+    bitbuffer_t *bits = &ctx->bits;
     float samples_per_us = pulses->sample_rate / 1.0e6f;
 
     int s_short = device->short_width * samples_per_us;
@@ -473,10 +661,10 @@ int pulse_slicer_manchester_zerobit(pulse_data_t const *pulses, r_device *device
 
     int events = 0;
     int time_since_last = 0;
-    bitbuffer_clear(&bits);
+    bitbuffer_clear(bits);
 
     // First rising edge is always counted as a zero (Seems to be hardcoded policy for the Oregon Scientific sensors...)
-    bitbuffer_add_bit(&bits, 0);
+    bitbuffer_add_bit(bits, 0);
 
     for (unsigned n = 0; n < pulses->num_pulses; ++n) {
         // The pulse or gap is too long or too short, thus invalid
@@ -488,17 +676,17 @@ int pulse_slicer_manchester_zerobit(pulse_data_t const *pulses, r_device *device
             if (pulses->pulse[n] > s_short * 1.5
                     && pulses->pulse[n] <= s_short * 2 + s_tolerance) {
                 // Long last pulse means with the gap this is a [1]10 transition, add a one
-                bitbuffer_add_bit(&bits, 1);
+                bitbuffer_add_bit(bits, 1);
             }
-            bitbuffer_add_row(&bits);
-            bitbuffer_add_bit(&bits, 0); // Prepare for new message with hardcoded 0
+            bitbuffer_add_row(bits);
+            bitbuffer_add_bit(bits, 0); // Prepare for new message with hardcoded 0
             time_since_last = 0;
         }
         // Falling edge is on end of pulse
         else if (pulses->pulse[n] + time_since_last > (s_short * 1.5)) {
             // Last bit was recorded more than short_width*1.5 samples ago
             // so this pulse start must be a data edge (falling data edge means bit = 1)
-            bitbuffer_add_bit(&bits, 1);
+            bitbuffer_add_bit(bits, 1);
             time_since_last = 0;
         }
         else {
@@ -508,17 +696,17 @@ int pulse_slicer_manchester_zerobit(pulse_data_t const *pulses, r_device *device
         // End of Message?
         if (((n == pulses->num_pulses - 1)                       // No more pulses? (FSK)
                     || (pulses->gap[n] > s_reset)) // Long silence (OOK)
-                && (bits.num_rows > 0)) {                        // Only if data has been accumulated
-            events += account_event(device, &bits, __func__);
-            bitbuffer_clear(&bits);
-            bitbuffer_add_bit(&bits, 0); // Prepare for new message with hardcoded 0
+                && (bits->num_rows > 0)) {                        // Only if data has been accumulated
+            events += account_event(ctx, device, bits, __func__);
+            bitbuffer_clear(bits);
+            bitbuffer_add_bit(bits, 0); // Prepare for new message with hardcoded 0
             time_since_last = 0;
         }
         // Rising edge is on end of gap
         else if (pulses->gap[n] + time_since_last > (s_short * 1.5)) {
             // Last bit was recorded more than short_width*1.5 samples ago
             // so this pulse end is a data edge (rising data edge means bit = 0)
-            bitbuffer_add_bit(&bits, 0);
+            bitbuffer_add_bit(bits, 0);
             time_since_last = 0;
         }
         else {
@@ -536,8 +724,9 @@ static inline int pulse_slicer_get_symbol(pulse_data_t const *pulses, unsigned i
         return pulses->gap[n / 2];
 }
 
-int pulse_slicer_dmc(pulse_data_t const *pulses, r_device *device)
+int pulse_slicer_dmc(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device *device)
 {
+    bitbuffer_t *bits = &ctx->bits;
     float samples_per_us = pulses->sample_rate / 1.0e6f;
 
     int s_short = device->short_width * samples_per_us;
@@ -558,7 +747,7 @@ int pulse_slicer_dmc(pulse_data_t const *pulses, r_device *device)
         return 0;
     }
 
-    bitbuffer_clear(&bits);
+    bitbuffer_clear(bits);
     int events = 0;
 
     for (unsigned int n = 0; n < pulses->num_pulses * 2; ++n) {
@@ -566,15 +755,15 @@ int pulse_slicer_dmc(pulse_data_t const *pulses, r_device *device)
 
         if (abs(symbol - s_short) < s_tolerance) {
             // Short - 1
-            bitbuffer_add_bit(&bits, 1);
+            bitbuffer_add_bit(bits, 1);
             symbol = n + 1 < pulses->num_pulses * 2 ? pulse_slicer_get_symbol(pulses, ++n) : 0;
             if (abs(symbol - s_short) > s_tolerance) {
                 if (symbol >= s_reset - s_tolerance) {
                     // Don't expect another short gap at end of message
                     n--;
                 }
-                else if (bits.num_rows > 0 && bits.bits_per_row[bits.num_rows - 1] > 0) {
-                    bitbuffer_add_row(&bits);
+                else if (bits->num_rows > 0 && bits->bits_per_row[bits->num_rows - 1] > 0) {
+                    bitbuffer_add_row(bits);
 /*
                     print_logf(LOG_WARNING, __func__, "Detected error during pulse_slicer_dmc(): %s",
                             device->name);
@@ -584,20 +773,21 @@ int pulse_slicer_dmc(pulse_data_t const *pulses, r_device *device)
         }
         else if (abs(symbol - s_long) < s_tolerance) {
             // Long - 0
-            bitbuffer_add_bit(&bits, 0);
+            bitbuffer_add_bit(bits, 0);
         }
         else if (symbol >= s_reset - s_tolerance
-                && bits.num_rows > 0) { // Only if data has been accumulated
+                && bits->num_rows > 0) { // Only if data has been accumulated
             //END message ?
-            events += account_event(device, &bits, __func__);
+            events += account_event(ctx, device, bits, __func__);
         }
     }
 
     return events;
 }
 
-int pulse_slicer_piwm_raw(pulse_data_t const *pulses, r_device *device)
+int pulse_slicer_piwm_raw(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device *device)
 {
+    bitbuffer_t *bits = &ctx->bits;
     float samples_per_us = pulses->sample_rate / 1.0e6f;
 
     int s_short = device->short_width * samples_per_us;
@@ -623,24 +813,24 @@ int pulse_slicer_piwm_raw(pulse_data_t const *pulses, r_device *device)
 
     int w;
 
-    bitbuffer_clear(&bits);
+    bitbuffer_clear(bits);
     int events = 0;
 
     for (unsigned int n = 0; n < pulses->num_pulses * 2; ++n) {
         int symbol = pulse_slicer_get_symbol(pulses, n);
         w = symbol * f_short + 0.5;
         if (symbol > s_long) {
-            bitbuffer_add_row(&bits);
+            bitbuffer_add_row(bits);
         }
         else if (abs(symbol - w * s_short) < s_tolerance) {
             // Add w symbols
             for (; w > 0; --w)
-                bitbuffer_add_bit(&bits, 1 - n % 2);
+                bitbuffer_add_bit(bits, 1 - n % 2);
         }
         else if (symbol < s_reset
-                && bits.num_rows > 0
-                && bits.bits_per_row[bits.num_rows - 1] > 0) {
-            bitbuffer_add_row(&bits);
+                && bits->num_rows > 0
+                && bits->bits_per_row[bits->num_rows - 1] > 0) {
+            bitbuffer_add_row(bits);
 /*
             print_logf(LOG_WARNING, __func__, "Detected error during pulse_slicer_piwm_raw(): %s",
                     device->name);
@@ -649,17 +839,18 @@ int pulse_slicer_piwm_raw(pulse_data_t const *pulses, r_device *device)
 
         if (((n == pulses->num_pulses * 2 - 1)              // No more pulses? (FSK)
                     || (symbol > s_reset)) // Long silence (OOK)
-                && (bits.num_rows > 0)) {                   // Only if data has been accumulated
+                && (bits->num_rows > 0)) {                   // Only if data has been accumulated
             //END message ?
-            events += account_event(device, &bits, __func__);
+            events += account_event(ctx, device, bits, __func__);
         }
     }
 
     return events;
 }
 
-int pulse_slicer_piwm_dc(pulse_data_t const *pulses, r_device *device)
+int pulse_slicer_piwm_dc(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device *device)
 {
+    bitbuffer_t *bits = &ctx->bits;
     float samples_per_us = pulses->sample_rate / 1.0e6f;
 
     int s_short = device->short_width * samples_per_us;
@@ -680,23 +871,23 @@ int pulse_slicer_piwm_dc(pulse_data_t const *pulses, r_device *device)
         return 0;
     }
 
-    bitbuffer_clear(&bits);
+    bitbuffer_clear(bits);
     int events = 0;
 
     for (unsigned int n = 0; n < pulses->num_pulses * 2; ++n) {
         int symbol = pulse_slicer_get_symbol(pulses, n);
         if (abs(symbol - s_short) < s_tolerance) {
             // Short - 1
-            bitbuffer_add_bit(&bits, 1);
+            bitbuffer_add_bit(bits, 1);
         }
         else if (abs(symbol - s_long) < s_tolerance) {
             // Long - 0
-            bitbuffer_add_bit(&bits, 0);
+            bitbuffer_add_bit(bits, 0);
         }
         else if (symbol < s_reset
-                && bits.num_rows > 0
-                && bits.bits_per_row[bits.num_rows - 1] > 0) {
-            bitbuffer_add_row(&bits);
+                && bits->num_rows > 0
+                && bits->bits_per_row[bits->num_rows - 1] > 0) {
+            bitbuffer_add_row(bits);
 /*
             print_logf(LOG_WARNING, __func__, "Detected error during pulse_slicer_piwm_dc(): %s",
                     device->name);
@@ -705,17 +896,18 @@ int pulse_slicer_piwm_dc(pulse_data_t const *pulses, r_device *device)
 
         if (((n == pulses->num_pulses * 2 - 1)              // No more pulses? (FSK)
                     || (symbol > s_reset)) // Long silence (OOK)
-                && (bits.num_rows > 0)) {                   // Only if data has been accumulated
+                && (bits->num_rows > 0)) {                   // Only if data has been accumulated
             //END message ?
-            events += account_event(device, &bits, __func__);
+            events += account_event(ctx, device, bits, __func__);
         }
     }
 
     return events;
 }
 
-int pulse_slicer_nrzs(pulse_data_t const *pulses, r_device *device)
+int pulse_slicer_nrzs(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device *device)
 {
+    bitbuffer_t *bits = &ctx->bits;
     float samples_per_us = pulses->sample_rate / 1.0e6f;
 
     int s_short = device->short_width * samples_per_us;
@@ -737,23 +929,23 @@ int pulse_slicer_nrzs(pulse_data_t const *pulses, r_device *device)
     }
 
     int events = 0;
-    bitbuffer_clear(&bits);
+    bitbuffer_clear(bits);
     int limit = s_short;
 
     for (unsigned n = 0; n < pulses->num_pulses; ++n) {
         if (pulses->pulse[n] > limit) {
             for (int i = 0 ; i < (pulses->pulse[n]/limit) ; i++) {
-                bitbuffer_add_bit(&bits, 1);
+                bitbuffer_add_bit(bits, 1);
             }
-            bitbuffer_add_bit(&bits, 0);
+            bitbuffer_add_bit(bits, 0);
         } else if (pulses->pulse[n] < limit) {
-            bitbuffer_add_bit(&bits, 0);
+            bitbuffer_add_bit(bits, 0);
         }
 
         if (n == pulses->num_pulses - 1
                     || pulses->gap[n] >= s_reset) {
 
-            events += account_event(device, &bits, __func__);
+            events += account_event(ctx, device, bits, __func__);
         }
     }
 
@@ -774,8 +966,9 @@ int pulse_slicer_nrzs(pulse_data_t const *pulses, r_device *device)
  * bit is discarded.
  */
 
-int pulse_slicer_osv1(pulse_data_t const *pulses, r_device *device)
+int pulse_slicer_osv1(pulse_slicer_ctx_t *ctx, pulse_data_t const *pulses, r_device *device)
 {
+    bitbuffer_t *bits = &ctx->bits;
     float samples_per_us = pulses->sample_rate / 1.0e6f;
 
     int s_short = device->short_width * samples_per_us;
@@ -800,7 +993,7 @@ int pulse_slicer_osv1(pulse_data_t const *pulses, r_device *device)
     int preamble = 0;
     int events = 0;
     int manbit = 0;
-    bitbuffer_clear(&bits);
+    bitbuffer_clear(bits);
     int halfbit_min = s_short / 2;
     int halfbit_max = s_short * 3 / 2;
     int sync_min = 2 * halfbit_max;
@@ -833,46 +1026,139 @@ int pulse_slicer_osv1(pulse_data_t const *pulses, r_device *device)
     if (pulses->gap[n] > pulses->pulse[n]) {
         manbit ^= 1;
         if (manbit)
-            bitbuffer_add_bit(&bits, 0);
+            bitbuffer_add_bit(bits, 0);
     }
 
     /* remaining data bits */
     for (n++; n < pulses->num_pulses; ++n) {
         manbit ^= 1;
         if (manbit)
-            bitbuffer_add_bit(&bits, 1);
+            bitbuffer_add_bit(bits, 1);
         if (pulses->pulse[n] > halfbit_max) {
             manbit ^= 1;
             if (manbit)
-                bitbuffer_add_bit(&bits, 1);
+                bitbuffer_add_bit(bits, 1);
         }
         if ((n == pulses->num_pulses - 1
                     || pulses->gap[n] > s_reset)
-                && (bits.num_rows > 0)) { // Only if data has been accumulated
+                && (bits->num_rows > 0)) { // Only if data has been accumulated
             //END message ?
-            events += account_event(device, &bits, __func__);
+            events += account_event(ctx, device, bits, __func__);
             return events;
         }
         manbit ^= 1;
         if (manbit)
-            bitbuffer_add_bit(&bits, 0);
+            bitbuffer_add_bit(bits, 0);
         if (pulses->gap[n] > halfbit_max) {
             manbit ^= 1;
             if (manbit)
-                bitbuffer_add_bit(&bits, 0);
+                bitbuffer_add_bit(bits, 0);
         }
     }
     return events;
 }
 
-int pulse_slicer_string(const char *code, r_device *device)
+int pulse_slicer_string(pulse_slicer_ctx_t *ctx, const char *code, r_device *device)
 {
+    bitbuffer_t *bits = &ctx->bits;
     int events = 0;
-    bitbuffer_clear(&bits);
+    bitbuffer_clear(bits);
 
-    bitbuffer_parse(&bits, code);
+    bitbuffer_parse(bits, code);
 
-    events += account_event(device, &bits, __func__);
+    events += account_event(ctx, device, bits, __func__);
 
     return events;
 }
+
+#ifdef _TEST
+#include "data.h"
+#include "bit_util.h"
+
+#define ASSERT_EQUALS(a, b) \
+    do { \
+        if ((a) == (b)) \
+            ++passed; \
+        else { \
+            ++failed; \
+            fprintf(stderr, "FAIL: line %d: %u <> %u\n", __LINE__, (unsigned)(a), (unsigned)(b)); \
+        } \
+    } while (0)
+
+extern r_device const tfa_303151;
+
+static unsigned test_outputs;
+
+static void test_output(r_device *decoder, data_t *data)
+{
+    (void)decoder;
+    ++test_outputs;
+    data_free(data);
+}
+
+/// Append the leading bits of a byte string to the current row.
+static void test_add_bits(bitbuffer_t *bits, uint8_t const *bytes, unsigned num_bits)
+{
+    for (unsigned i = 0; i < num_bits; ++i)
+        bitbuffer_add_bit(bits, bytes[i / 8] >> (7 - i % 8) & 1);
+}
+
+int main(void)
+{
+    unsigned passed = 0;
+    unsigned failed = 0;
+    static pulse_slicer_ctx_t ctx;
+    bitbuffer_t *bits = &ctx.bits;
+    uint8_t const ook_preamble[] = {0xff};
+    uint8_t const fsk_preamble[] = {0xaa, 0xaa, 0xaa, 0x2d, 0xd4};
+    uint8_t const fsk_gap[] = {0x00, 0x00};
+    uint8_t msg[9] = {0x5a, 0xb1, 0x90, 0x40, 0x02, 0x05, 0x00, 0x2a};
+    msg[8] = crc8(msg, 8, 0x31, 0x00);
+
+    r_device dev = tfa_303151;
+    dev.output_fn = test_output;
+
+    fprintf(stderr, "pulse_slicer:: test\n");
+
+    fprintf(stderr, "pulse_slicer:: tfa_303151 accepts an OOK frame with 8 bit preamble\n");
+    bitbuffer_clear(bits);
+    test_add_bits(bits, ook_preamble, 8);
+    test_add_bits(bits, msg, 72);
+    test_outputs = 0;
+    account_event(&ctx, &dev, bits, __func__);
+    ASSERT_EQUALS(test_outputs, 1);
+
+    fprintf(stderr, "pulse_slicer:: tfa_303151 accepts an OOK frame with 7 bit preamble\n");
+    bitbuffer_clear(bits);
+    test_add_bits(bits, ook_preamble, 7);
+    test_add_bits(bits, msg, 72);
+    test_outputs = 0;
+    account_event(&ctx, &dev, bits, __func__);
+    ASSERT_EQUALS(test_outputs, 1);
+
+    fprintf(stderr, "pulse_slicer:: tfa_303151 accepts an FSK frame\n");
+    bitbuffer_clear(bits);
+    test_add_bits(bits, fsk_preamble, 40);
+    test_add_bits(bits, msg, 72);
+    test_add_bits(bits, fsk_gap, 11);
+    test_outputs = 0;
+    account_event(&ctx, &dev, bits, __func__);
+    ASSERT_EQUALS(test_outputs, 1);
+
+    fprintf(stderr, "pulse_slicer:: tfa_303151 rejects more than one row\n");
+    bitbuffer_clear(bits);
+    test_add_bits(bits, ook_preamble, 8);
+    test_add_bits(bits, msg, 72);
+    bitbuffer_add_row(bits);
+    test_add_bits(bits, ook_preamble, 8);
+    test_add_bits(bits, msg, 72);
+    test_outputs = 0;
+    account_event(&ctx, &dev, bits, __func__);
+    ASSERT_EQUALS(test_outputs, 0);
+    ASSERT_EQUALS(dev.decode_events, 3);
+
+    fprintf(stderr, "pulse_slicer:: test (%u/%u) passed, (%u) failed.\n", passed, passed + failed, failed);
+
+    return failed;
+}
+#endif /* _TEST */
@@ -21,8 +21,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#include <time.h>
 
 #include "pulse_slicer.h"
+#include "pulse_hist.h"
 #include "r_device.h"
 #include "r_private.h"
 #include "r_util.h"
@@ -64,7 +66,233 @@ r_cfg_t* r_create_cfg(void) {
 
 /* device decoder protocols */
 
+/// Resolve the slicer for a modulation, sets fsk to the pulse data family it expects.
+static pulse_slicer_fn resolve_slicer(unsigned modulation, int* fsk) {
+  *fsk = modulation >= FSK_DEMOD_MIN_VAL;
+  switch (modulation) {
+    case OOK_PULSE_PCM:
+      // case OOK_PULSE_RZ:
+      return pulse_slicer_pcm;
+    case OOK_PULSE_PPM:
+      return pulse_slicer_ppm;
+    case OOK_PULSE_PWM:
+      return pulse_slicer_pwm;
+    case OOK_PULSE_MANCHESTER_ZEROBIT:
+      return pulse_slicer_manchester_zerobit;
+    case OOK_PULSE_PIWM_RAW:
+      return pulse_slicer_piwm_raw;
+    case OOK_PULSE_PIWM_DC:
+      return pulse_slicer_piwm_dc;
+    case OOK_PULSE_DMC:
+      return pulse_slicer_dmc;
+    case OOK_PULSE_PWM_OSV1:
+      return pulse_slicer_osv1;
+    case OOK_PULSE_NRZS:
+      return pulse_slicer_nrzs;
+    // FSK decoders
+    case FSK_PULSE_PCM:
+      return pulse_slicer_pcm;
+    case FSK_PULSE_PWM:
+      return pulse_slicer_pwm;
+    case FSK_PULSE_MANCHESTER_ZEROBIT:
+      return pulse_slicer_manchester_zerobit;
+    default:
+      return NULL;
+  }
+}
+
+/// Check if two devices slice a pulse train identically.
+static int same_slicer_params(r_device const* a, r_device const* b) {
+  return a->modulation == b->modulation
+      && a->short_width == b->short_width
+      && a->long_width == b->long_width
+      && a->reset_limit == b->reset_limit
+      && a->gap_limit == b->gap_limit
+      && a->sync_width == b->sync_width
+      && a->tolerance == b->tolerance;
+}
+
+/// Set an inclusive width range in microseconds for an entry filter, widened by a bucket for rounding.
+static void dispatch_filter_range(dispatch_entry_t* entry, int idx, float lo_us, float hi_us) {
+  unsigned lo = pulse_hist_bucket(lo_us);
+  unsigned hi = pulse_hist_bucket(hi_us);
+  entry->range_lo[idx] = lo > 0 ? lo - 1 : 0;
+  entry->range_hi[idx] = hi + 1;
+}
+
+/// Derive the width histogram support the slicer of an entry needs to add any bits.
+/// Only slicers with hard timing windows are filtered, the filter never drops a bit the slicer would keep.
+static void dispatch_filter_init(dispatch_entry_t* entry) {
+  r_device const* r_dev = entry->r_dev;
+  float s_short = r_dev->short_width;
+  float s_long = r_dev->long_width;
+  float s_tolerance = r_dev->tolerance;
+
+  entry->filter = DISPATCH_FILTER_NONE;
+  entry->range_lo[0] = entry->range_lo[1] = 1;
+  entry->range_hi[0] = entry->range_hi[1] = 0;
+
+  switch (r_dev->modulation) {
+    case OOK_PULSE_PWM:
+    case FSK_PULSE_PWM:
+      // only short and long pulses add bits
+      if (s_tolerance > 0) {
+        entry->filter = DISPATCH_FILTER_PULSE;
+        dispatch_filter_range(entry, 0, s_short - s_tolerance, s_short + s_tolerance);
+        dispatch_filter_range(entry, 1, s_long - s_tolerance, s_long + s_tolerance);
+      }
+      break;
+    case OOK_PULSE_PPM:
+      // only short and long gaps add bits
+      entry->filter = DISPATCH_FILTER_GAP;
+      if (s_tolerance > 0) {
+        dispatch_filter_range(entry, 0, s_short - s_tolerance, s_short + s_tolerance);
+        dispatch_filter_range(entry, 1, s_long - s_tolerance, s_long + s_tolerance);
+      } else {
+        dispatch_filter_range(entry, 0, 0, r_dev->gap_limit > 0 ? r_dev->gap_limit : r_dev->reset_limit);
+      }
+      break;
+    case OOK_PULSE_PCM:
+    case FSK_PULSE_PCM:
+      if (s_short != s_long) {
+        // RZ: any pulse off the nominal width clears the bits
+        if (s_tolerance <= 0)
+          s_tolerance = s_long / 4;
+        entry->filter = DISPATCH_FILTER_PULSE;
+        dispatch_filter_range(entry, 0, s_short - s_tolerance, s_short + s_tolerance);
+      } else {
+        // NRZ: widths below half the (at most halved by tuning) bit period add no bits
+        entry->filter = DISPATCH_FILTER_ANY;
+        dispatch_filter_range(entry, 0, s_short / 4, PULSE_HIST_BUCKET_US * PULSE_HIST_BUCKETS);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+/// Check if a pulse train histogram supports the timings of an entry.
+static int dispatch_filter_match(dispatch_entry_t const* entry, pulse_hist_t const* hist) {
+  for (int i = 0; i < 2; ++i) {
+    unsigned lo = entry->range_lo[i];
+    unsigned hi = entry->range_hi[i];
+    if (entry->filter != DISPATCH_FILTER_GAP && pulse_hist_any(hist->pulse, lo, hi))
+      return 1;
+    if (entry->filter != DISPATCH_FILTER_PULSE && pulse_hist_any(hist->gap, lo, hi))
+      return 1;
+  }
+  return 0;
+}
+
+/// Dispatcher state of a registered device.
+static dispatch_dev_t* dispatch_dev(struct dm_state* demod, r_device const* r_dev) {
+  return &demod->devs[r_dev->protocol_num];
+}
+
+/// Add to a counter only the dispatching task writes, as an atomic store since readers on other tasks load it.
+static inline void dispatch_count(unsigned* counter, unsigned n) {
+  __atomic_store_n(counter, *counter + n, __ATOMIC_RELAXED);
+}
+
+/// Read a setting a runtime setter may change from another task.
+#define DISPATCH_SETTING(field) __atomic_load_n(&(field), __ATOMIC_RELAXED)
+
+/// Rebuild a dispatch plan from the registered devices of one modulation family.
+/// Entries are grouped by ascending priority, keeping registration order within a priority.
+/// Devices of a priority with identical slicer parameters share one entry, chained by slice_next.
+static void dispatch_plan_build(struct dm_state* demod, dispatch_plan_t* plan, int fsk) {
+  list_t const* r_devs = &demod->r_devs;
+  size_t num_devs = r_devs->len;
+
+  plan->entries = realloc(plan->entries, (num_devs + 1) * sizeof(*plan->entries));
+  plan->levels = realloc(plan->levels, (num_devs + 1) * sizeof(*plan->levels));
+  if (!plan->entries || !plan->levels)
+    FATAL_CALLOC("dispatch_plan_build()");
+  plan->num_entries = 0;
+  plan->num_levels = 0;
+  plan->cache.used = 0;
+
+  unsigned next_priority = 0; // next smallest on each pass through the devices
+  for (unsigned priority = 0; priority < UINT_MAX; priority = next_priority) {
+    next_priority = UINT_MAX;
+    dispatch_level_t* level = &plan->levels[plan->num_levels];
+    level->priority = priority;
+    level->first = plan->num_entries;
+    level->count = 0;
+
+    for (void** iter = r_devs->elems; iter && *iter; ++iter) {
+      r_device* r_dev = *iter;
+
+      // Find next smallest priority
+      if (r_dev->priority > priority && r_dev->priority < next_priority)
+        next_priority = r_dev->priority;
+      // Collect only current priority
+      if (r_dev->priority != priority)
+        continue;
+
+      int dev_fsk;
+      pulse_slicer_fn slicer = resolve_slicer(r_dev->modulation, &dev_fsk);
+      if (!slicer) {
+        if (!fsk) // report only once, not per family
+          fprintf(stderr, "Unknown modulation %u in protocol!\n",
+                  r_dev->modulation);
+        continue;
+      }
+      if (dev_fsk != fsk)
+        continue;
+
+      dispatch_dev(demod, r_dev)->slice_next = NULL;
+      dispatch_entry_t* entry = &plan->entries[level->first];
+      dispatch_entry_t* end = &plan->entries[plan->num_entries];
+      while (entry < end && !same_slicer_params(entry->r_dev, r_dev))
+        ++entry;
+      if (entry < end) {
+        r_device* last = entry->r_dev;
+        while (dispatch_dev(demod, last)->slice_next)
+          last = dispatch_dev(demod, last)->slice_next;
+        dispatch_dev(demod, last)->slice_next = r_dev;
+        continue;
+      }
+
+      entry = &plan->entries[plan->num_entries++];
+      entry->slicer = slicer;
+      entry->r_dev = r_dev;
+      dispatch_filter_init(entry);
+      level->count++;
+    }
+
+    if (level->count)
+      plan->num_levels++;
+  }
+}
+
+/// Rebuild the OOK and FSK dispatch plans from the registered devices.
+static void dispatch_plans_build(struct dm_state* demod) {
+  dispatch_plan_build(demod, &demod->ook_plan, 0);
+  dispatch_plan_build(demod, &demod->fsk_plan, 1);
+}
+
+/// Make room in the dispatcher state for a protocol number.
+static void dispatch_devs_reserve(struct dm_state* demod, unsigned protocol_num) {
+  if (protocol_num < demod->num_devs)
+    return;
+  unsigned num_devs = demod->num_devs * 2 > protocol_num ? demod->num_devs * 2 : protocol_num + 1;
+  dispatch_dev_t* devs = realloc(demod->devs, num_devs * sizeof(*devs));
+  if (!devs)
+    FATAL_CALLOC("dispatch_devs_reserve()");
+  memset(devs + demod->num_devs, 0, (num_devs - demod->num_devs) * sizeof(*devs));
+  demod->devs = devs;
+  demod->num_devs = num_devs;
+}
+
 void register_protocol(r_cfg_t* cfg, r_device* r_dev, char* arg) {
+  // the dispatcher keeps its state per protocol number
+  dispatch_devs_reserve(cfg->demod, r_dev->protocol_num);
+  if (cfg->demod->devs[r_dev->protocol_num].r_dev) {
+    fprintf(stderr, "Protocol [%u] \"%s\" is already registered!\n", r_dev->protocol_num, r_dev->name);
+    return;
+  }
+
   // use arg of 'v', 'vv', 'vvv' as device verbosity
   int dev_verbose = 0;
   if (arg && *arg == 'v') {
@@ -80,6 +308,8 @@ void register_protocol(r_cfg_t* cfg, r_device* r_dev, char* arg) {
   r_device* p;
   if (r_dev->create_fn) {
     p = r_dev->create_fn(arg);
+    if (!p)
+      FATAL_CALLOC("register_protocol()");
   } else {
     if (arg && *arg) {
       fprintf(stderr, "Protocol [%u] \"%s\" does not take arguments \"%s\"!\n",
@@ -99,6 +329,8 @@ void register_protocol(r_cfg_t* cfg, r_device* r_dev, char* arg) {
   p->output_ctx = cfg;
 
   list_push(&cfg->demod->r_devs, p);
+  cfg->demod->devs[p->protocol_num].r_dev = p;
+  cfg->demod->plans_stale = 1; // built once with the first signal, not per registration
 
   if (cfg->verbosity >= LOG_INFO) {
     fprintf(stderr, "Registering protocol [%u] \"%s\"\n", r_dev->protocol_num,
@@ -106,118 +338,672 @@ void register_protocol(r_cfg_t* cfg, r_device* r_dev, char* arg) {
   }
 }
 
-int run_ook_demods(list_t* r_devs, pulse_data_t* pulse_data) {
-  int p_events = 0;
+/// Sum the successful decodes, including restored ones, and the average decode times
+/// of the devices sharing the slice of an entry.
+static void dispatch_entry_measure(struct dm_state* demod, dispatch_entry_t* entry) {
+  entry->hits = 0;
+  entry->cost_ns = 0;
+  for (r_device const* r_dev = entry->r_dev; r_dev; r_dev = dispatch_dev(demod, r_dev)->slice_next) {
+    dispatch_dev_t const* state = dispatch_dev(demod, r_dev);
+    entry->hits += r_dev->decode_ok + __atomic_load_n(&state->prior_hits, __ATOMIC_RELAXED);
+    entry->cost_ns += __atomic_load_n(&state->cost_ns, __ATOMIC_RELAXED);
+  }
+}
 
-  unsigned next_priority = 0; // next smallest on each loop through decoders
-  // run all decoders of each priority, stop if an event is produced
-  for (unsigned priority = 0; !p_events && priority < UINT_MAX;
-       priority = next_priority) {
-    next_priority = UINT_MAX;
-    for (void** iter = r_devs->elems; iter && *iter; ++iter) {
-      r_device* r_dev = *iter;
+/// Whether entry a runs before entry b in the given dispatch_order.
+/// By hits per cost the entries compare by (hits + 1) / cost, so among entries
+/// without hits the cheapest run first, entries never run count as cheapest.
+static int dispatch_entry_before(dispatch_entry_t const* a, dispatch_entry_t const* b, int order) {
+  if (order != DISPATCH_ORDER_HITS_PER_COST)
+    return a->hits > b->hits;
+  uint64_t a_rate = (uint64_t)(a->hits + 1) * (b->cost_ns ? b->cost_ns : 1);
+  uint64_t b_rate = (uint64_t)(b->hits + 1) * (a->cost_ns ? a->cost_ns : 1);
+  return a_rate > b_rate;
+}
 
-      // Find next smallest priority
-      if (r_dev->priority > priority && r_dev->priority < next_priority)
-        next_priority = r_dev->priority;
-      // Run only current priority
-      if (r_dev->priority != priority)
-        continue;
+/// Sort the entries of each priority level by descending hits, or hits per cost.
+/// The sort is stable so entries without hits keep their registration order.
+static void dispatch_plan_reorder(struct dm_state* demod, dispatch_plan_t* plan, int order) {
+  for (unsigned i = 0; i < plan->num_entries; ++i)
+    dispatch_entry_measure(demod, &plan->entries[i]);
 
-      switch (r_dev->modulation) {
-        case OOK_PULSE_PCM:
-          // case OOK_PULSE_RZ:
-          p_events += pulse_slicer_pcm(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_PPM:
-          p_events += pulse_slicer_ppm(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_PWM:
-          p_events += pulse_slicer_pwm(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_MANCHESTER_ZEROBIT:
-          p_events += pulse_slicer_manchester_zerobit(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_PIWM_RAW:
-          p_events += pulse_slicer_piwm_raw(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_PIWM_DC:
-          p_events += pulse_slicer_piwm_dc(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_DMC:
-          p_events += pulse_slicer_dmc(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_PWM_OSV1:
-          p_events += pulse_slicer_osv1(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_NRZS:
-          p_events += pulse_slicer_nrzs(pulse_data, r_dev);
-          break;
-        // FSK decoders
-        case FSK_PULSE_PCM:
-        case FSK_PULSE_PWM:
-        case FSK_PULSE_MANCHESTER_ZEROBIT:
-          break;
-        default:
-          fprintf(stderr, "Unknown modulation %u in protocol!\n",
-                  r_dev->modulation);
+  for (unsigned l = 0; l < plan->num_levels; ++l) {
+    dispatch_entry_t* first = &plan->entries[plan->levels[l].first];
+    dispatch_entry_t* end = first + plan->levels[l].count;
+    for (dispatch_entry_t* entry = first + 1; entry < end; ++entry) {
+      dispatch_entry_t key = *entry;
+      dispatch_entry_t* hole = entry;
+      for (; hole > first && dispatch_entry_before(&key, &hole[-1], order); --hole)
+        hole[0] = hole[-1];
+      *hole = key;
+    }
+  }
+}
+
+/// Resize the fingerprint cache of a plan, dropping all slots.
+static void dispatch_cache_resize(dispatch_cache_t* cache, unsigned size) {
+  free(cache->slots);
+  cache->slots = NULL;
+  cache->size = 0;
+  cache->used = 0;
+  if (!size)
+    return;
+  cache->slots = calloc(size, sizeof(*cache->slots));
+  if (!cache->slots)
+    FATAL_CALLOC("dispatch_cache_resize()");
+  cache->size = size;
+}
+
+/// Look up a fingerprint and make it the most recently used slot, NULL on a miss.
+static dispatch_cache_slot_t* dispatch_cache_find(dispatch_cache_t* cache, uint32_t fingerprint) {
+  for (unsigned i = 0; i < cache->used; ++i) {
+    if (cache->slots[i].fingerprint == fingerprint) {
+      dispatch_cache_slot_t slot = cache->slots[i];
+      memmove(&cache->slots[1], &cache->slots[0], i * sizeof(*cache->slots));
+      cache->slots[0] = slot;
+      return &cache->slots[0];
+    }
+  }
+  return NULL;
+}
+
+/// Record the entry decoding a fingerprint as most recently used, evicting the least recently used slot.
+static void dispatch_cache_store(dispatch_cache_t* cache, uint32_t fingerprint, dispatch_entry_t const* entry) {
+  dispatch_cache_slot_t* slot = dispatch_cache_find(cache, fingerprint);
+  if (!slot) {
+    if (cache->used < cache->size)
+      cache->used++;
+    memmove(&cache->slots[1], &cache->slots[0], (cache->used - 1) * sizeof(*cache->slots));
+    slot = &cache->slots[0];
+    slot->fingerprint = fingerprint;
+  }
+  slot->slicer = entry->slicer;
+  slot->r_dev = entry->r_dev;
+}
+
+/// Drop the most recently used slot.
+static void dispatch_cache_drop_first(dispatch_cache_t* cache) {
+  if (!cache->used)
+    return;
+  cache->used--;
+  memmove(&cache->slots[0], &cache->slots[1], cache->used * sizeof(*cache->slots));
+}
+
+/// Apply the requested dispatch settings, called from the dispatching task only.
+static void dispatch_settings_apply(struct dm_state* demod) {
+  if (demod->plans_stale) {
+    demod->plans_stale = 0;
+    dispatch_plans_build(demod);
+    demod->adaptive_countdown = 0; // a rebuilt plan is in registration order
+  }
+  unsigned cache_size = DISPATCH_SETTING(demod->cache_size);
+  if (demod->ook_plan.cache.size != cache_size) {
+    dispatch_cache_resize(&demod->ook_plan.cache, cache_size);
+    dispatch_cache_resize(&demod->fsk_plan.cache, cache_size);
+  }
+
+  if (__atomic_exchange_n(&demod->model_loaded, 0, __ATOMIC_ACQUIRE)) {
+    demod->adaptive_countdown = 0;
+  }
+  int adaptive_order = DISPATCH_SETTING(demod->adaptive_order);
+  if (demod->adaptive_applied != adaptive_order) {
+    demod->adaptive_applied = adaptive_order;
+    demod->adaptive_countdown = 0;
+    if (!demod->adaptive_applied)
+      dispatch_plans_build(demod); // back to registration order
+  }
+  if (!demod->adaptive_applied)
+    return;
+
+  if (demod->adaptive_countdown) {
+    demod->adaptive_countdown--;
+    return;
+  }
+  demod->adaptive_countdown = demod->adaptive_period ? demod->adaptive_period : DISPATCH_ADAPTIVE_PERIOD;
+  dispatch_plan_reorder(demod, &demod->ook_plan, demod->adaptive_applied);
+  dispatch_plan_reorder(demod, &demod->fsk_plan, demod->adaptive_applied);
+  dispatch_count(&demod->dispatch_stats.reorders, 1);
+}
+
+/// Leave demoted devices of a slice chain out of the current signal unless it is their sampled turn.
+/// Returns the number of chained devices that run.
+static unsigned dispatch_demotion_select(struct dm_state* demod, dispatch_stats_t* stats, r_device* chain) {
+  unsigned sample = DISPATCH_SETTING(demod->demote_sample);
+  sample = sample ? sample : DISPATCH_DEMOTE_SAMPLE;
+  unsigned runs = 0;
+  for (r_device* r_dev = chain; r_dev; r_dev = dispatch_dev(demod, r_dev)->slice_next) {
+    dispatch_dev_t* state = dispatch_dev(demod, r_dev);
+    state->dispatch_skip = 0;
+    if (DISPATCH_SETTING(demod->demote_after) && state->demoted) {
+      if (state->sample_countdown) {
+        state->sample_countdown--;
+        state->dispatch_skip = 1;
+        dispatch_count(&stats->demoted_skips, 1);
+      } else {
+        state->sample_countdown = sample - 1;
       }
     }
+    runs += !state->dispatch_skip;
   }
+  return runs;
+}
 
-  return p_events;
+/// Demote devices of a slice chain that ran often without any success, promote demoted ones that succeeded.
+static void dispatch_demotion_update(struct dm_state* demod, dispatch_stats_t* stats, r_device* chain) {
+  unsigned sample = DISPATCH_SETTING(demod->demote_sample);
+  sample = sample ? sample : DISPATCH_DEMOTE_SAMPLE;
+  for (r_device* r_dev = chain; r_dev; r_dev = dispatch_dev(demod, r_dev)->slice_next) {
+    dispatch_dev_t* state = dispatch_dev(demod, r_dev);
+    if (state->demoted && r_dev->decode_ok) {
+      __atomic_store_n(&state->demoted, 0, __ATOMIC_RELAXED);
+      dispatch_count(&stats->promotions, 1);
+    } else if (!state->demoted && !r_dev->decode_ok && r_dev->decode_events >= DISPATCH_SETTING(demod->demote_after)) {
+      __atomic_store_n(&state->demoted, 1, __ATOMIC_RELAXED);
+      state->sample_countdown = sample - 1;
+      dispatch_count(&stats->demotions, 1);
+    }
+  }
+}
+
+/// Monotonic time in microseconds for the decode time budget.
+static uint64_t dispatch_now_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/// Whether any device of the slice chain of an entry is urgent.
+static int dispatch_entry_urgent(struct dm_state* demod, dispatch_entry_t const* entry) {
+  for (r_device const* r_dev = entry->r_dev; r_dev; r_dev = dispatch_dev(demod, r_dev)->slice_next) {
+    if (DISPATCH_SETTING(dispatch_dev(demod, r_dev)->urgent))
+      return 1;
+  }
+  return 0;
+}
+
+/// Account every stride-th entry left out of a signal once the decode time budget is spent,
+/// only those of the given urgency unless it is -1.
+static void dispatch_budget_skip(struct dm_state* demod, dispatch_stats_t* stats, dispatch_entry_t const* entry,
+    dispatch_entry_t const* end, unsigned stride, int urgent) {
+  for (; entry < end; entry += stride) {
+    if (urgent >= 0 && dispatch_entry_urgent(demod, entry) != urgent)
+      continue;
+    dispatch_count(&stats->budget_skips, 1);
+    for (r_device* r_dev = entry->r_dev; r_dev; r_dev = dispatch_dev(demod, r_dev)->slice_next)
+      dispatch_count(&dispatch_dev(demod, r_dev)->budget_skips, 1);
+  }
+}
+
+/// Results of one partition of a level sweep.
+typedef struct dispatch_part {
+  pulse_slicer_ctx_t* ctx;
+  int events;
+  dispatch_entry_t const* winner; ///< First entry of the partition producing events.
+  int budget_spent;
+  dispatch_stats_t stats; ///< Merged into the dm_state counters after the level.
+} dispatch_part_t;
+
+/// One level of a plan swept by num_parts partitions, partition p runs every num_parts-th entry from p.
+typedef struct dispatch_sweep {
+  struct dm_state* demod;
+  pulse_data_t* pulse_data;
+  pulse_hist_t hist;
+  uint64_t deadline;         ///< End of the decode time budget, 0 for no limit.
+  r_device const* tried;     ///< Entry already run from the fingerprint cache.
+  int urgent;                ///< Run only urgent entries if 1, only the others if 0, all if -1.
+  dispatch_entry_t const* first;
+  dispatch_entry_t const* end;
+  unsigned num_parts;
+  dispatch_part_t parts[DISPATCH_MAX_PARTS];
+} dispatch_sweep_t;
+
+/// Run one partition of the current level, called concurrently for all partitions of a split sweep.
+/// The partitions own disjoint devices, all shared counters go to the partition stats.
+static void dispatch_sweep_part(void* arg, unsigned part) {
+  dispatch_sweep_t* sweep = arg;
+  struct dm_state* demod = sweep->demod;
+  dispatch_part_t* p = &sweep->parts[part];
+  unsigned stride = sweep->num_parts;
+
+  for (dispatch_entry_t const* entry = sweep->first + part; entry < sweep->end; entry += stride) {
+    if (p->events && DISPATCH_SETTING(demod->first_hit_stop)) {
+      p->stats.first_hit_stops++;
+      p->stats.first_hit_skips += (sweep->end - entry + stride - 1) / stride;
+      break;
+    }
+    if (sweep->deadline && dispatch_now_us() >= sweep->deadline) {
+      p->budget_spent = 1;
+      dispatch_budget_skip(demod, &p->stats, entry, sweep->end, stride, sweep->urgent);
+      break;
+    }
+    if (entry->r_dev == sweep->tried)
+      continue;
+    if (sweep->urgent >= 0 && dispatch_entry_urgent(demod, entry) != sweep->urgent)
+      continue;
+    if (entry->filter != DISPATCH_FILTER_NONE && !dispatch_filter_match(entry, &sweep->hist))
+      continue;
+    if (!dispatch_demotion_select(demod, &p->stats, entry->r_dev))
+      continue;
+    int events = entry->slicer(p->ctx, sweep->pulse_data, entry->r_dev);
+    if (DISPATCH_SETTING(demod->demote_after))
+      dispatch_demotion_update(demod, &p->stats, entry->r_dev);
+    if (events && !p->winner)
+      p->winner = entry;
+    p->events += events;
+  }
+}
+
+/// Add the counters a sweep partition touches.
+static void dispatch_stats_merge(dispatch_stats_t* stats, dispatch_stats_t const* part) {
+  dispatch_count(&stats->first_hit_stops, part->first_hit_stops);
+  dispatch_count(&stats->first_hit_skips, part->first_hit_skips);
+  dispatch_count(&stats->demotions, part->demotions);
+  dispatch_count(&stats->promotions, part->promotions);
+  dispatch_count(&stats->demoted_skips, part->demoted_skips);
+  dispatch_count(&stats->budget_skips, part->budget_skips);
 }
 
-int run_fsk_demods(list_t* r_devs, pulse_data_t* fsk_pulse_data) {
+/// Run the plan entries level by level, stop at the first level producing events.
+/// Entries whose timings have no support in the width histogram of the pulse data are skipped.
+/// Decoders demoted by the demotion policy only run on sampled signals.
+/// With a decode time budget the remaining entries are left out once it is spent,
+/// checked between entries as a running decoder can not be interrupted.
+/// With the fingerprint cache enabled the entry that decoded the same timing signature last
+/// is tried first, the full sweep only runs if that finds no events. The cached entry is
+/// subject to demotion and its time to the budget, a sweep after it may find the budget spent.
+/// All slicing state lives in ctxs, callers dispatching concurrently pass contexts each.
+/// With num_parts > 1 each level is split into partitions run through fork, which returns
+/// once all partitions are done, so no level starts before the previous one is merged.
+/// An urgent signal sweeps each level twice, the urgent entries first, so they are not left
+/// to a first hit stop or a spent budget.
+static int run_dispatch_plan(struct dm_state* demod, pulse_slicer_ctx_t** ctxs, unsigned num_parts,
+    dispatch_fork_fn fork, void* fork_ctx, dispatch_plan_t* plan, pulse_data_t* pulse_data) {
   int p_events = 0;
 
-  unsigned next_priority = 0; // next smallest on each loop through decoders
-  // run all decoders of each priority, stop if an event is produced
-  for (unsigned priority = 0; !p_events && priority < UINT_MAX;
-       priority = next_priority) {
-    next_priority = UINT_MAX;
-    for (void** iter = r_devs->elems; iter && *iter; ++iter) {
-      r_device* r_dev = *iter;
+  dispatch_settings_apply(demod);
+  dispatch_count(&demod->dispatch_stats.signals, 1);
 
-      // Find next smallest priority
-      if (r_dev->priority > priority && r_dev->priority < next_priority)
-        next_priority = r_dev->priority;
-      // Run only current priority
-      if (r_dev->priority != priority)
-        continue;
+  if (num_parts > DISPATCH_MAX_PARTS)
+    num_parts = DISPATCH_MAX_PARTS;
+  if (!fork)
+    num_parts = 1;
+  for (unsigned i = 0; i < num_parts; ++i) {
+    ctxs[i]->devs = demod->devs;
+    ctxs[i]->timed = demod->adaptive_applied == DISPATCH_ORDER_HITS_PER_COST;
+  }
 
-      switch (r_dev->modulation) {
-        // OOK decoders
-        case OOK_PULSE_PCM:
-        // case OOK_PULSE_RZ:
-        case OOK_PULSE_PPM:
-        case OOK_PULSE_PWM:
-        case OOK_PULSE_MANCHESTER_ZEROBIT:
-        case OOK_PULSE_PIWM_RAW:
-        case OOK_PULSE_PIWM_DC:
-        case OOK_PULSE_DMC:
-        case OOK_PULSE_PWM_OSV1:
-        case OOK_PULSE_NRZS:
-          break;
-        case FSK_PULSE_PCM:
-          p_events += pulse_slicer_pcm(fsk_pulse_data, r_dev);
-          break;
-        case FSK_PULSE_PWM:
-          p_events += pulse_slicer_pwm(fsk_pulse_data, r_dev);
-          break;
-        case FSK_PULSE_MANCHESTER_ZEROBIT:
-          p_events += pulse_slicer_manchester_zerobit(fsk_pulse_data, r_dev);
-          break;
-        default:
-          fprintf(stderr, "Unknown modulation %u in protocol!\n",
-                  r_dev->modulation);
+  // the budget starts before the cached decoder, which counts against it like any other
+  unsigned budget_us = DISPATCH_SETTING(demod->budget_us);
+  uint64_t deadline = budget_us ? dispatch_now_us() + budget_us : 0;
+
+  uint32_t fingerprint = 0;
+  r_device const* tried = NULL;
+  if (plan->cache.size) {
+    fingerprint = pulse_hist_fingerprint(pulse_data);
+    dispatch_cache_slot_t const* slot = dispatch_cache_find(&plan->cache, fingerprint);
+    if (slot) {
+      dispatch_count(&demod->dispatch_stats.cache_hits, 1);
+      // demoted devices of the cached slice keep to their samples, the slicer skips them
+      if (dispatch_demotion_select(demod, &demod->dispatch_stats, slot->r_dev)) {
+        p_events = slot->slicer(ctxs[0], pulse_data, slot->r_dev);
+        if (DISPATCH_SETTING(demod->demote_after))
+          dispatch_demotion_update(demod, &demod->dispatch_stats, slot->r_dev);
+      }
+      if (p_events)
+        return p_events;
+      dispatch_count(&demod->dispatch_stats.cache_stale, 1);
+      tried = slot->r_dev;
+    }
+    else {
+      dispatch_count(&demod->dispatch_stats.cache_misses, 1);
+    }
+  }
+
+  dispatch_sweep_t sweep;
+  sweep.demod = demod;
+  sweep.pulse_data = pulse_data;
+  pulse_hist_build(&sweep.hist, pulse_data);
+  sweep.deadline = deadline;
+  sweep.tried = tried;
+  sweep.urgent = -1;
+  unsigned passes = 1;
+  if (demod->urgent_signal) {
+    dispatch_count(&demod->dispatch_stats.urgent_signals, 1);
+    passes = 2;
+  }
+  dispatch_entry_t const* winner = NULL;
+  int budget_spent = 0;
+  for (unsigned l = 0; !p_events && !budget_spent && l < plan->num_levels; ++l) {
+    sweep.first = &plan->entries[plan->levels[l].first];
+    sweep.end = sweep.first + plan->levels[l].count;
+    sweep.num_parts = num_parts < plan->levels[l].count ? num_parts : plan->levels[l].count;
+
+    for (unsigned pass = 0; !budget_spent && pass < passes; ++pass) {
+      if (pass && p_events && DISPATCH_SETTING(demod->first_hit_stop))
+        break; // the urgent entries decoded it
+      sweep.urgent = passes == 1 ? -1 : pass == 0;
+      for (unsigned i = 0; i < sweep.num_parts; ++i) {
+        dispatch_part_t* p = &sweep.parts[i];
+        memset(p, 0, sizeof(*p));
+        p->ctx = ctxs[i];
       }
+
+      if (sweep.num_parts > 1)
+        fork(fork_ctx, dispatch_sweep_part, &sweep, sweep.num_parts);
+      else
+        dispatch_sweep_part(&sweep, 0);
+
+      for (unsigned i = 0; i < sweep.num_parts; ++i) {
+        dispatch_part_t const* p = &sweep.parts[i];
+        p_events += p->events;
+        if (p->winner && (!winner || p->winner < winner))
+          winner = p->winner;
+        budget_spent |= p->budget_spent;
+        dispatch_stats_merge(&demod->dispatch_stats, &p->stats);
+      }
+    }
+    if (budget_spent) {
+      dispatch_count(&demod->dispatch_stats.budget_exhausted, 1);
+      // spent on the urgent entries, the others of the level did not get their pass
+      if (sweep.urgent == 1)
+        dispatch_budget_skip(demod, &demod->dispatch_stats, sweep.first, sweep.end, 1, 0);
+      // as no events were found below the current level the rest of the plan would have run
+      if (!p_events)
+        dispatch_budget_skip(demod, &demod->dispatch_stats, sweep.end, &plan->entries[plan->num_entries], 1, -1);
+      break;
     }
   }
 
+  if (winner && plan->cache.size)
+    dispatch_cache_store(&plan->cache, fingerprint, winner);
+  else if (tried)
+    dispatch_cache_drop_first(&plan->cache);
+
   return p_events;
 }
 
+int run_ook_demods(struct dm_state* demod, pulse_slicer_ctx_t* ctx, pulse_data_t* pulse_data) {
+  return run_dispatch_plan(demod, &ctx, 1, NULL, NULL, &demod->ook_plan, pulse_data);
+}
+
+int run_fsk_demods(struct dm_state* demod, pulse_slicer_ctx_t* ctx, pulse_data_t* fsk_pulse_data) {
+  return run_dispatch_plan(demod, &ctx, 1, NULL, NULL, &demod->fsk_plan, fsk_pulse_data);
+}
+
+/// Decode one signal with the entries of each priority level split into num_parts partitions.
+/// Partition p slices with ctxs[p], fork runs the partitions of a level concurrently and is the
+/// merge barrier: the next level only starts if no partition found events.
+/// Decoders of different partitions may output concurrently, the output callback must allow that.
+int run_ook_demods_split(struct dm_state* demod, pulse_slicer_ctx_t** ctxs, unsigned num_parts,
+    dispatch_fork_fn fork, void* fork_ctx, pulse_data_t* pulse_data) {
+  return run_dispatch_plan(demod, ctxs, num_parts, fork, fork_ctx, &demod->ook_plan, pulse_data);
+}
+
+int run_fsk_demods_split(struct dm_state* demod, pulse_slicer_ctx_t** ctxs, unsigned num_parts,
+    dispatch_fork_fn fork, void* fork_ctx, pulse_data_t* fsk_pulse_data) {
+  return run_dispatch_plan(demod, ctxs, num_parts, fork, fork_ctx, &demod->fsk_plan, fsk_pulse_data);
+}
+
+/// Request adaptive ordering of the decoders within each priority, safe to call from another task
+/// while dispatching. The dispatcher picks the settings up with the next signal, disabling restores
+/// registration order. All setters below store atomically for the same reason.
+/// An enable of DISPATCH_ORDER_HITS_PER_COST weighs the hits with the decode times, only measured then.
+void set_adaptive_order(r_cfg_t* cfg, int enable, int first_hit_stop) {
+  __atomic_store_n(&cfg->demod->first_hit_stop, first_hit_stop, __ATOMIC_RELAXED);
+  __atomic_store_n(&cfg->demod->adaptive_order, enable, __ATOMIC_RELAXED);
+}
+
+/// Request a fingerprint cache of the given number of slots per modulation family, 0 to disable.
+/// Safe to call while dispatching, the dispatcher resizes the cache with the next signal.
+void set_fingerprint_cache(r_cfg_t* cfg, unsigned size) {
+  __atomic_store_n(&cfg->demod->cache_size, size, __ATOMIC_RELAXED);
+}
+
+/// Demote decoders that ran after_runs times without a single success to run on one in sample signals,
+/// a demoted decoder is promoted back on its first success. An after_runs of 0 disables the policy,
+/// a sample of 0 selects DISPATCH_DEMOTE_SAMPLE.
+void set_demotion_policy(r_cfg_t* cfg, unsigned after_runs, unsigned sample) {
+  __atomic_store_n(&cfg->demod->demote_sample, sample, __ATOMIC_RELAXED);
+  __atomic_store_n(&cfg->demod->demote_after, after_runs, __ATOMIC_RELAXED);
+}
+
+/// Limit the time spent dispatching one signal to budget_us microseconds, 0 for no limit.
+void set_decode_budget(r_cfg_t* cfg, unsigned budget_us) {
+  __atomic_store_n(&cfg->demod->budget_us, budget_us, __ATOMIC_RELAXED);
+}
+
+/// Mark the registered devices of the given name as urgent or not, returns the number of devices found.
+/// Safe to call while dispatching, the flag is read as each level is swept.
+int set_device_urgent(r_cfg_t* cfg, char const* name, int urgent) {
+  int found = 0;
+  for (void** iter = cfg->demod->r_devs.elems; iter && *iter; ++iter) {
+    r_device* r_dev = *iter;
+    if (!strcmp(r_dev->name, name)) {
+      __atomic_store_n(&dispatch_dev(cfg->demod, r_dev)->urgent, urgent != 0, __ATOMIC_RELAXED);
+      found++;
+    }
+  }
+  return found;
+}
+
+/// Dispatch the following signals with the urgent devices of each priority level first.
+void set_urgent_signal(r_cfg_t* cfg, int urgent) {
+  cfg->demod->urgent_signal = urgent;
+}
+
+/// Saved dispatch model: a header followed by one record per registered device.
+#define DISPATCH_MODEL_MAGIC 0x4d443352 // "R3DM"
+#define DISPATCH_MODEL_VERSION 1
+
+typedef struct dispatch_model_header {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t count;
+} dispatch_model_header_t;
+
+typedef struct dispatch_model_record {
+  uint32_t name_hash; ///< Protocol numbers change with the compiled decoder set, names do not.
+  uint32_t cost_ns;
+  uint32_t hits;
+} dispatch_model_record_t;
+
+/// FNV-1a hash of a device name.
+static uint32_t dispatch_model_hash(char const* name) {
+  uint32_t hash = 2166136261u;
+  for (; *name; ++name)
+    hash = (hash ^ (uint8_t)*name) * 16777619u;
+  return hash;
+}
+
+/// The state of a device registered alike in another configuration, NULL if it is not.
+static dispatch_dev_t const* dispatch_dev_in(r_cfg_t* cfg, r_device const* r_dev) {
+  struct dm_state* demod = cfg->demod;
+  if (r_dev->protocol_num >= demod->num_devs || !demod->devs[r_dev->protocol_num].r_dev)
+    return NULL;
+  return &demod->devs[r_dev->protocol_num];
+}
+
+/// Save the learned decode times and hits of all registered devices, e.g. to flash.
+/// With several configurations registered alike, e.g. one per decoder task, the hits are
+/// summed and the decode times averaged over them. Safe while they keep dispatching.
+/// Returns the size of the model, nothing is written if buf is NULL or smaller than that.
+size_t save_dispatch_model(r_cfg_t* const* cfgs, unsigned num_cfgs, void* buf, size_t size) {
+  list_t* r_devs = &cfgs[0]->demod->r_devs;
+  size_t need = sizeof(dispatch_model_header_t) + r_devs->len * sizeof(dispatch_model_record_t);
+  if (!buf || size < need)
+    return need;
+
+  dispatch_model_header_t header = {DISPATCH_MODEL_MAGIC, DISPATCH_MODEL_VERSION, (uint16_t)r_devs->len};
+  uint8_t* p = buf;
+  memcpy(p, &header, sizeof(header));
+  p += sizeof(header);
+  for (void** iter = r_devs->elems; iter && *iter; ++iter) {
+    r_device* r_dev = *iter;
+    // a loaded model is restored into every configuration alike, count it once
+    uint64_t hits = __atomic_load_n(&dispatch_dev(cfgs[0]->demod, r_dev)->prior_hits, __ATOMIC_RELAXED);
+    uint64_t cost_ns = 0;
+    unsigned measured = 0;
+    for (unsigned c = 0; c < num_cfgs; ++c) {
+      dispatch_dev_t const* state = dispatch_dev_in(cfgs[c], r_dev);
+      if (!state)
+        continue;
+      hits += __atomic_load_n(&state->r_dev->decode_ok, __ATOMIC_RELAXED);
+      unsigned cost = __atomic_load_n(&state->cost_ns, __ATOMIC_RELAXED);
+      if (cost) {
+        cost_ns += cost;
+        measured++;
+      }
+    }
+    dispatch_model_record_t record = {
+        dispatch_model_hash(r_dev->name),
+        measured ? (uint32_t)(cost_ns / measured) : 0,
+        hits < UINT32_MAX ? (uint32_t)hits : UINT32_MAX,
+    };
+    memcpy(p, &record, sizeof(record));
+    p += sizeof(record);
+  }
+  return need;
+}
+
+/// Restore a model saved by save_dispatch_model(), best before signals are processed.
+/// Devices not in the model keep their state, the plans are reordered with the next signal.
+/// Returns the number of devices restored, -1 if the model is not valid.
+int load_dispatch_model(r_cfg_t* cfg, void const* buf, size_t size) {
+  dispatch_model_header_t header;
+  if (!buf || size < sizeof(header))
+    return -1;
+  memcpy(&header, buf, sizeof(header));
+  if (header.magic != DISPATCH_MODEL_MAGIC || header.version != DISPATCH_MODEL_VERSION
+      || size < sizeof(header) + header.count * sizeof(dispatch_model_record_t))
+    return -1;
+
+  uint8_t const* records = (uint8_t const*)buf + sizeof(header);
+  int restored = 0;
+  for (void** iter = cfg->demod->r_devs.elems; iter && *iter; ++iter) {
+    r_device* r_dev = *iter;
+    uint32_t name_hash = dispatch_model_hash(r_dev->name);
+    for (unsigned i = 0; i < header.count; ++i) {
+      dispatch_model_record_t record;
+      memcpy(&record, records + i * sizeof(record), sizeof(record));
+      if (record.name_hash != name_hash)
+        continue;
+      __atomic_store_n(&dispatch_dev(cfg->demod, r_dev)->cost_ns, record.cost_ns, __ATOMIC_RELAXED);
+      __atomic_store_n(&dispatch_dev(cfg->demod, r_dev)->prior_hits, record.hits, __ATOMIC_RELAXED);
+      restored++;
+      break;
+    }
+  }
+  __atomic_store_n(&cfg->demod->model_loaded, 1, __ATOMIC_RELEASE);
+  return restored;
+}
+
+/// Retries of a statistics read overlapping an update, before giving up.
+/// Bounded as the updating task may be preempted by the reading one on the same core.
+#define DECODER_STATS_RETRIES 64
+
+/// Copy the statistics of a device, retrying while its decoder task updates them.
+/// Returns 0 on a consistent copy, -1 if every retry overlapped an update.
+static int read_decoder_stats(r_device const* r_dev, decoder_stats_t* out) {
+  for (int retry = 0; retry < DECODER_STATS_RETRIES; ++retry) {
+    unsigned seq = __atomic_load_n(&r_dev->stats_seq, __ATOMIC_ACQUIRE);
+    out->events = __atomic_load_n(&r_dev->decode_events, __ATOMIC_RELAXED);
+    out->ok = __atomic_load_n(&r_dev->decode_ok, __ATOMIC_RELAXED);
+    out->messages = __atomic_load_n(&r_dev->decode_messages, __ATOMIC_RELAXED);
+    for (int i = 0; i < 5; ++i)
+      out->fails[i] = __atomic_load_n(&r_dev->decode_fails[i], __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (!(seq & 1) && seq == __atomic_load_n(&r_dev->stats_seq, __ATOMIC_RELAXED))
+      return 0;
+  }
+  return -1;
+}
+
+/// Add the statistics of the registered devices to stats, by registration order, without
+/// stopping the task decoding with cfg. Each device is read consistently on its own.
+/// Sums the devices of several configurations registered alike when called for each.
+/// Returns the number of registered devices, at most count entries of stats are updated,
+/// or -1 if a device was being updated on every retry. Its entry is then left as it was and
+/// the caller should retry once the decoding task had a chance to finish the update.
+int add_decoder_stats(r_cfg_t* cfg, decoder_stats_t* stats, unsigned count) {
+  list_t* r_devs = &cfg->demod->r_devs;
+  int result = (int)r_devs->len;
+  for (unsigned i = 0; i < r_devs->len && i < count; ++i) {
+    r_device const* r_dev = r_devs->elems[i];
+    decoder_stats_t read;
+    stats[i].protocol_num = r_dev->protocol_num;
+    stats[i].name = r_dev->name;
+    if (read_decoder_stats(r_dev, &read)) {
+      result = -1;
+      continue;
+    }
+    stats[i].events += read.events;
+    stats[i].ok += read.ok;
+    stats[i].messages += read.messages;
+    for (int f = 0; f < 5; ++f)
+      stats[i].fails[f] += read.fails[f];
+  }
+  return result;
+}
+
+/// Add the dispatch counters of a configuration to stats, without stopping its dispatching task.
+void add_dispatch_stats(r_cfg_t* cfg, dispatch_stats_t* stats) {
+  // all fields are unsigned counters
+  unsigned const* from = (unsigned const*)&cfg->demod->dispatch_stats;
+  unsigned* to = (unsigned*)stats;
+  for (size_t i = 0; i < sizeof(*stats) / sizeof(unsigned); ++i)
+    to[i] += __atomic_load_n(&from[i], __ATOMIC_RELAXED);
+}
+
+/// Report of the dispatch counters, the decoders currently demoted to sampled runs
+/// and the decoders left out because the decode time budget was spent.
+/// Sums several configurations registered alike, "demoted" counts those demoting a decoder.
+data_t* create_dispatch_report(r_cfg_t* const* cfgs, unsigned num_cfgs) {
+  list_t* r_devs = &cfgs[0]->demod->r_devs;
+  list_t dev_data_list = {0};
+  list_ensure_size(&dev_data_list, r_devs->len);
+
+  for (void** iter = r_devs->elems; iter && *iter; ++iter) {
+    r_device* r_dev = *iter;
+    unsigned events = 0;
+    unsigned demoted = 0;
+    unsigned budget_skips = 0;
+    for (unsigned c = 0; c < num_cfgs; ++c) {
+      dispatch_dev_t const* state = dispatch_dev_in(cfgs[c], r_dev);
+      if (!state)
+        continue;
+      events += __atomic_load_n(&state->r_dev->decode_events, __ATOMIC_RELAXED);
+      demoted += __atomic_load_n(&state->demoted, __ATOMIC_RELAXED);
+      budget_skips += __atomic_load_n(&state->budget_skips, __ATOMIC_RELAXED);
+    }
+    if (!demoted && !budget_skips)
+      continue;
+    data_t* data = data_make(
+        "device", "", DATA_INT, r_dev->protocol_num,
+        "name", "", DATA_STRING, r_dev->name,
+        "events", "", DATA_INT, events,
+        "demoted", "", DATA_INT, demoted,
+        "budget_skips", "", DATA_INT, budget_skips,
+        NULL);
+    list_push(&dev_data_list, data);
+  }
+
+  dispatch_stats_t stats = {0};
+  for (unsigned c = 0; c < num_cfgs; ++c)
+    add_dispatch_stats(cfgs[c], &stats);
+  data_t* data = data_make(
+      "signals", "", DATA_INT, stats.signals,
+      "demotions", "", DATA_INT, stats.demotions,
+      "promotions", "", DATA_INT, stats.promotions,
+      "demoted_skips", "", DATA_INT, stats.demoted_skips,
+      "budget_exhausted", "", DATA_INT, stats.budget_exhausted,
+      "budget_skips", "", DATA_INT, stats.budget_skips,
+      "devices", "", DATA_ARRAY, data_array(dev_data_list.len, DATA_DATA, dev_data_list.elems),
+      NULL);
+
+  list_free_elems(&dev_data_list, NULL);
+  return data;
+}
+
 /* handlers */
 /** Pass the data structure to all output handlers. Frees data afterwards. */
 
@@ -412,6 +1198,8 @@ void data_acquired_handler(r_device* r_dev, data_t* data) {
 
   //data_append(data, "protocol", "", DATA_STRING, r_dev->name,NULL);
   data = data_str(data, "protocol", "protocol", NULL, r_dev->name);
+  if (cfg->report_source)
+    data = data_int(data, "source", "Source", NULL, cfg->source);
   
   size_t message_size = 2000; // should be plenty big
   char *message       = (char *) malloc(message_size);
@@ -429,3 +1217,175 @@ void data_acquired_handler(r_device* r_dev, data_t* data) {
   data_free(data);
 }
 
+
+#ifdef _TEST
+#define ASSERT_EQUALS(a, b) \
+  do { \
+    if ((a) == (b)) \
+      ++passed; \
+    else { \
+      ++failed; \
+      fprintf(stderr, "FAIL: line %d: %u <> %u\n", __LINE__, (unsigned)(a), (unsigned)(b)); \
+    } \
+  } while (0)
+
+#define TEST_DEVS 8
+
+static unsigned test_calls[TEST_DEVS]; // decode_fn runs by protocol_num
+static unsigned test_winner;           // protocol_num of the device decoding every signal, 0 for none
+
+static int test_decode(r_device* decoder, bitbuffer_t* bitbuffer) {
+  (void)bitbuffer;
+  test_calls[decoder->protocol_num]++;
+  return decoder->protocol_num == test_winner;
+}
+
+/// Register a PWM test device, short pulses are 1 bits and long pulses 0 bits.
+static void test_register(r_cfg_t* cfg, unsigned protocol_num, unsigned modulation,
+    float short_width, float long_width, unsigned priority) {
+  r_device dev = {0};
+  dev.protocol_num = protocol_num;
+  dev.name = "Test";
+  dev.modulation = modulation;
+  dev.short_width = short_width;
+  dev.long_width = long_width;
+  dev.tolerance = short_width / 4;
+  dev.reset_limit = long_width * 4;
+  dev.priority = priority;
+  dev.decode_fn = test_decode;
+  register_protocol(cfg, &dev, NULL);
+}
+
+/// Fill a PWM pulse train of alternating bits, at one sample per microsecond.
+static void test_pulses(pulse_data_t* pulses, int short_width, int long_width) {
+  memset(pulses, 0, sizeof(*pulses));
+  pulses->sample_rate = 1000000;
+  pulses->num_pulses = 24;
+  for (unsigned i = 0; i < pulses->num_pulses; ++i) {
+    pulses->pulse[i] = i & 1 ? long_width : short_width;
+    pulses->gap[i] = long_width;
+  }
+  pulses->gap[pulses->num_pulses - 1] = long_width * 8;
+}
+
+/// Plan entry slicing a protocol, NULL if it is not the first device of an entry.
+static dispatch_entry_t* test_entry(dispatch_plan_t* plan, unsigned protocol_num) {
+  for (unsigned i = 0; i < plan->num_entries; ++i) {
+    if (plan->entries[i].r_dev->protocol_num == protocol_num)
+      return &plan->entries[i];
+  }
+  return NULL;
+}
+
+int main(void) {
+  unsigned passed = 0;
+  unsigned failed = 0;
+  r_cfg_t cfg;
+  static pulse_data_t pulses;
+  static pulse_slicer_ctx_t ctx;
+  pulse_hist_t hist;
+
+  fprintf(stderr, "r_api:: test\n");
+
+  fprintf(stderr, "r_api:: histogram prefilter skips devices without timing support\n");
+  memset(&cfg, 0, sizeof(cfg));
+  r_init_cfg(&cfg);
+  test_register(&cfg, 1, OOK_PULSE_PWM, 500, 1000, 0);
+  test_register(&cfg, 2, OOK_PULSE_PWM, 1500, 3000, 0);
+  dispatch_plans_build(cfg.demod);
+  test_pulses(&pulses, 500, 1000);
+  pulse_hist_build(&hist, &pulses);
+  ASSERT_EQUALS(test_entry(&cfg.demod->ook_plan, 1)->filter, DISPATCH_FILTER_PULSE);
+  ASSERT_EQUALS(dispatch_filter_match(test_entry(&cfg.demod->ook_plan, 1), &hist), 1);
+  ASSERT_EQUALS(dispatch_filter_match(test_entry(&cfg.demod->ook_plan, 2), &hist), 0);
+  memset(test_calls, 0, sizeof(test_calls));
+  test_winner = 0;
+  run_ook_demods(cfg.demod, &ctx, &pulses);
+  ASSERT_EQUALS(test_calls[1], 1);
+  ASSERT_EQUALS(test_calls[2], 0);
+  test_pulses(&pulses, 1500, 3000);
+  pulse_hist_build(&hist, &pulses);
+  ASSERT_EQUALS(dispatch_filter_match(test_entry(&cfg.demod->ook_plan, 1), &hist), 0);
+  ASSERT_EQUALS(dispatch_filter_match(test_entry(&cfg.demod->ook_plan, 2), &hist), 1);
+
+  fprintf(stderr, "r_api:: fingerprint cache keeps the most recently used slots\n");
+  dispatch_cache_t cache = {0};
+  dispatch_cache_resize(&cache, 2);
+  dispatch_cache_store(&cache, 11, test_entry(&cfg.demod->ook_plan, 1));
+  dispatch_cache_store(&cache, 22, test_entry(&cfg.demod->ook_plan, 2));
+  ASSERT_EQUALS(cache.used, 2);
+  ASSERT_EQUALS(dispatch_cache_find(&cache, 11)->r_dev->protocol_num, 1);
+  dispatch_cache_store(&cache, 33, test_entry(&cfg.demod->ook_plan, 2));
+  ASSERT_EQUALS(cache.used, 2);
+  ASSERT_EQUALS(dispatch_cache_find(&cache, 22) == NULL, 1);
+  ASSERT_EQUALS(dispatch_cache_find(&cache, 11) != NULL, 1);
+  ASSERT_EQUALS(dispatch_cache_find(&cache, 33) != NULL, 1);
+  dispatch_cache_resize(&cache, 0);
+
+  fprintf(stderr, "r_api:: fingerprint cache hits the decoder that matched\n");
+  set_fingerprint_cache(&cfg, 1);
+  memset(test_calls, 0, sizeof(test_calls));
+  test_winner = 2;
+  run_ook_demods(cfg.demod, &ctx, &pulses);
+  run_ook_demods(cfg.demod, &ctx, &pulses);
+  ASSERT_EQUALS(cfg.demod->dispatch_stats.cache_misses, 1);
+  ASSERT_EQUALS(cfg.demod->dispatch_stats.cache_hits, 1);
+  ASSERT_EQUALS(test_calls[2], 2);
+
+  fprintf(stderr, "r_api:: fingerprint cache evicts a signature for a new one\n");
+  test_winner = 1;
+  test_pulses(&pulses, 500, 1000);
+  run_ook_demods(cfg.demod, &ctx, &pulses);
+  ASSERT_EQUALS(cfg.demod->dispatch_stats.cache_misses, 2);
+  test_winner = 2;
+  test_pulses(&pulses, 1500, 3000);
+  run_ook_demods(cfg.demod, &ctx, &pulses);
+  ASSERT_EQUALS(cfg.demod->dispatch_stats.cache_misses, 3);
+  ASSERT_EQUALS(cfg.demod->dispatch_stats.cache_hits, 1);
+
+  fprintf(stderr, "r_api:: dispatch plans are split by family and ordered by priority\n");
+  memset(&cfg, 0, sizeof(cfg));
+  r_init_cfg(&cfg);
+  test_register(&cfg, 1, OOK_PULSE_PWM, 500, 1000, 10);
+  test_register(&cfg, 2, OOK_PULSE_PWM, 500, 1000, 0);
+  test_register(&cfg, 3, FSK_PULSE_PWM, 500, 1000, 0);
+  test_register(&cfg, 4, OOK_PULSE_PWM, 600, 1200, 5);
+  test_register(&cfg, 5, OOK_PULSE_PWM, 400, 800, 0);
+  test_register(&cfg, 6, OOK_PULSE_PWM, 500, 1000, 0);
+  dispatch_plans_build(cfg.demod);
+  dispatch_plan_t* plan = &cfg.demod->ook_plan;
+  ASSERT_EQUALS(plan->num_levels, 3);
+  ASSERT_EQUALS(plan->levels[0].priority, 0);
+  ASSERT_EQUALS(plan->levels[1].priority, 5);
+  ASSERT_EQUALS(plan->levels[2].priority, 10);
+  ASSERT_EQUALS(plan->num_entries, 4);
+  ASSERT_EQUALS(plan->levels[0].count, 2);
+  ASSERT_EQUALS(plan->entries[0].r_dev->protocol_num, 2);
+  ASSERT_EQUALS(plan->entries[1].r_dev->protocol_num, 5);
+  ASSERT_EQUALS(plan->entries[2].r_dev->protocol_num, 4);
+  ASSERT_EQUALS(plan->entries[3].r_dev->protocol_num, 1);
+  ASSERT_EQUALS(cfg.demod->devs[2].slice_next->protocol_num, 6);
+  ASSERT_EQUALS(cfg.demod->fsk_plan.num_entries, 1);
+  ASSERT_EQUALS(cfg.demod->fsk_plan.entries[0].r_dev->protocol_num, 3);
+
+  fprintf(stderr, "r_api:: a priority level finding events ends the dispatch\n");
+  memset(test_calls, 0, sizeof(test_calls));
+  test_winner = 6;
+  test_pulses(&pulses, 500, 1000);
+  run_ook_demods(cfg.demod, &ctx, &pulses);
+  ASSERT_EQUALS(test_calls[2], 1);
+  ASSERT_EQUALS(test_calls[6], 1);
+  ASSERT_EQUALS(test_calls[1], 0);
+  ASSERT_EQUALS(test_calls[3], 0);
+  memset(test_calls, 0, sizeof(test_calls));
+  test_winner = 1;
+  run_ook_demods(cfg.demod, &ctx, &pulses);
+  ASSERT_EQUALS(test_calls[2], 1);
+  ASSERT_EQUALS(test_calls[4], 1);
+  ASSERT_EQUALS(test_calls[1], 1);
+
+  fprintf(stderr, "r_api:: test (%u/%u) passed, (%u) failed.\n", passed, passed + failed, failed);
+
+  return failed;
+}
+#endif /* _TEST */
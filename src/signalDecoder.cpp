@@ -31,103 +31,943 @@ r_device r_devices[] = {
   #undef DECL
 };
 
+void rtl_433_Decoder::setupConfig(r_cfg_t* cfg) {
+  r_init_cfg(cfg);
+
+  cfg->conversion_mode = CONVERT_SI; // Default all output to Celsius
+  cfg->num_r_devices = sizeof(r_devices) / sizeof(*r_devices);
+  cfg->devices = r_devices; 
+  cfg->verbosity = rtlVerbose; // 0=normal, 1=verbose, 2=verbose decoders,
+
+  // expand register_all_protocols to determine heap impact from each decoder
+  // register_all_protocols(cfg, 0);
+
+  for (int i = 0; i < cfg->num_r_devices; i++) {
+    // register all device protocols that are not disabled
+    cfg->devices[i].protocol_num = i+1;
+
+    char* arg = NULL;
+    if (cfg->devices[i].disabled <= 0) {
+      register_protocol(cfg, &cfg->devices[i], arg);
+    }
+  }
+  set_adaptive_order(cfg, adaptiveOrderMode(), _firstHitStop);
+  set_fingerprint_cache(cfg, _fingerprintCacheSlots);
+  set_demotion_policy(cfg, _demoteAfterRuns, _demoteSample);
+  set_decode_budget(cfg, _decodeBudgetUs);
+  cfg->report_source = _numSources > 1;
+
+  static const char* const urgent[] = {rtl_433_Decoder_Urgent_Devices};
+  for (unsigned i = 0; i < sizeof(urgent) / sizeof(*urgent); i++) {
+    set_device_urgent(cfg, urgent[i], 1);
+  }
+}
+
 void rtl_433_Decoder::rtlSetup() {
-  r_cfg_t* cfg = &g_cfg;
   const int rtl_433_Decoder_Stack=_ookModulation ? 11500 : 20000; // per rtl_433_ESP
 
-  if (!cfg->demod) {
-    r_init_cfg(cfg);
+  if (!g_cfg.demod) {
+    // without worker tasks the first decoder state still serves the Sync calls
+    unsigned states = _workerCount ? _workerCount : 1;
+    _workers = (decode_worker_t*)calloc(states, sizeof(decode_worker_t));
+    if (!_workers) {
+      FATAL_CALLOC("rtlSetup()");
+    }
+    for (unsigned i = 0; i < states; i++) {
+      decode_worker_t* worker = &_workers[i];
+      worker->decoder = this;
+      worker->cfg = i ? (r_cfg_t*)calloc(1, sizeof(r_cfg_t)) : &g_cfg;
+      if (!worker->cfg) {
+        FATAL_CALLOC("rtlSetup()");
+      }
+      setupConfig(worker->cfg);
+      worker->cfg->callback = workerOutput;
+      worker->cfg->ctx = worker;
 
-    cfg->conversion_mode = CONVERT_SI; // Default all output to Celsius
-    cfg->num_r_devices = sizeof(r_devices) / sizeof(*r_devices);
-    cfg->devices = r_devices; 
-    cfg->verbosity = rtlVerbose; // 0=normal, 1=verbose, 2=verbose decoders,
+      worker->num_parts = _dispatchParts;
+      for (unsigned part = 0; part < worker->num_parts; part++) {
+        worker->slicers[part] = (pulse_slicer_ctx_t*)calloc(1, sizeof(pulse_slicer_ctx_t));
+        if (!worker->slicers[part]) {
+          FATAL_CALLOC("rtlSetup()");
+        }
+      }
+      if (worker->num_parts > 1) {
+        worker->helpers = (decode_helper_t*)calloc(worker->num_parts - 1, sizeof(decode_helper_t));
+        if (!worker->helpers) {
+          FATAL_CALLOC("rtlSetup()");
+        }
+        worker->done = port_sem_create(worker->num_parts - 1, 0);
+        worker->outputLock = port_mutex_create();
+      }
+    }
+    _workers[0].stateLock = port_mutex_create();
 
-    // expand register_all_protocols to determine heap impact from each decoder
-    // register_all_protocols(cfg, 0);
+    unsigned queued = 0;
+    for (unsigned i = 0; i < _numSources; i++) {
+      decode_source_t* source = &_sources[i];
+      source->stats.queue.depth = source->depth ? source->depth : _queueDepth;
+      source->stats.weight = source->weight ? source->weight : 1;
+      source->queue = port_queue_create(source->stats.queue.depth, sizeof(decode_job_t*));
+      queued += source->stats.queue.depth;
+    }
+    _urgentQueue = port_queue_create(_queueDepth, sizeof(decode_job_t*));
+    queued += _queueDepth;
+    _jobsReady = port_sem_create(queued, 0);
+    _sourceLock = port_mutex_create();
 
-    for (int i = 0; i < cfg->num_r_devices; i++) {
-      // register all device protocols that are not disabled
-      cfg->devices[i].protocol_num = i+1;
+    // a job holds its slot from submission until delivery, that is while queued, decoding or waiting on earlier jobs.
+    // Twice what the queues and workers hold, so signals dropped to make room keep theirs without starving new ones.
+    _reorderWindow = 1;
+    while (_reorderWindow < 2 * (queued + states)) {
+      _reorderWindow <<= 1;
+    }
+    _reorderSlots = (decode_job_t**)calloc(_reorderWindow, sizeof(decode_job_t*));
+    if (!_reorderSlots) {
+      FATAL_CALLOC("rtlSetup()");
+    }
+    _reorderLock = port_mutex_create();
+    _reorderRoom = port_sem_create(_reorderWindow, _reorderWindow);
 
-      char* arg = NULL;
-      if (cfg->devices[i].disabled <= 0) {
-        register_protocol(cfg, &cfg->devices[i], arg);
+    // full pulse trains are only held until packed, every job holds a reorder slot, so the job pool never runs out
+    unsigned pulses = _pulsePoolSize ? _pulsePoolSize : _numSources + 1;
+    unsigned packs = _packPoolSize ? _packPoolSize : queued + states;
+    void* pulseStorage = port_malloc(block_pool_storage_size(pulses, sizeof(pulse_data_t)));
+    void* packStorage = port_malloc(block_pool_storage_size(packs, pulse_pack_size(rtl_433_Decoder_Pack_Words)));
+    void* jobStorage = malloc(block_pool_storage_size(_reorderWindow, sizeof(decode_job_t)));
+    if (!pulseStorage || !packStorage || !jobStorage
+        || block_pool_init(&_pulsePool, pulseStorage, pulses, sizeof(pulse_data_t))
+        || block_pool_init(&_packPool, packStorage, packs, pulse_pack_size(rtl_433_Decoder_Pack_Words))
+        || block_pool_init(&_jobPool, jobStorage, _reorderWindow, sizeof(decode_job_t))) {
+      FATAL_CALLOC("rtlSetup()");
+    }
+    for (unsigned i = 0; i < _workerCount; i++) {
+      _workers[i].pulses = (pulse_data_t*)port_malloc(sizeof(pulse_data_t));
+      if (!_workers[i].pulses) {
+        FATAL_CALLOC("rtlSetup()");
       }
     }
 
-    rtl_433_Queue = xQueueCreate(5, sizeof(decode_job_t*));
+    // the Sync calls fork on the first state's helpers too, so every state gets them, worker task or not.
+    // Helpers start before the workers, which must not fork on parts whose helper failed to start.
+    for (unsigned i = 0; i < states; i++) {
+      int core = _workerFirstCore == PORT_NO_AFFINITY ? PORT_NO_AFFINITY : (_workerFirstCore + i) % port_num_cores();
+      for (unsigned part = 1; part < _workers[i].num_parts; part++) {
+        decode_helper_t* helper = &_workers[i].helpers[part - 1];
+        helper->worker = &_workers[i];
+        helper->part = part;
+        helper->start = port_sem_create(1, 0);
+        if (!port_task_create(
+            this->rtl_433_HelperTask,
+            "rtl_433_HelperTask",
+            rtl_433_Decoder_Stack,
+            helper,
+            rtl_433_Decoder_Priority,
+            core == PORT_NO_AFFINITY ? PORT_NO_AFFINITY : (core + part) % port_num_cores(),
+            &helper->handle)) {
+          logprintfLn(LOG_ERR, "ERROR: rtlSetup() could not start helper task %u of worker %u, dispatching in %u parts",
+                      part, i, part);
+          _workers[i].num_parts = part;
+          break;
+        }
+      }
+    }
 
-    xTaskCreatePinnedToCore(
-        this->rtl_433_DecoderTask, /* Function to implement the task */
-        "rtl_433_DecoderTask", /* Name of the task */
-        rtl_433_Decoder_Stack, /* Stack size in bytes */
-        this, /* Task input parameter */
-        rtl_433_Decoder_Priority, /* Priority of the task (set lower than core task) */
-        &rtl_433_DecoderHandle, /* Task handle. */
-        rtl_433_Decoder_Core); /* Core where the task should run */
+    // workers that fail to start are dropped, with none left every signal is decoded on the caller's thread
+    unsigned started = 0;
+    for (; started < _workerCount; started++) {
+      int core = _workerFirstCore == PORT_NO_AFFINITY ? PORT_NO_AFFINITY : (_workerFirstCore + started) % port_num_cores();
+      if (!port_task_create(
+          this->rtl_433_DecoderTask, /* Function to implement the task */
+          "rtl_433_DecoderTask", /* Name of the task */
+          rtl_433_Decoder_Stack, /* Stack size in bytes */
+          &_workers[started], /* Task input parameter */
+          rtl_433_Decoder_Priority, /* Priority of the task (set lower than core task) */
+          core, /* Core where the task should run */
+          &_workers[started].handle)) { /* Task handle. */
+        logprintfLn(LOG_ERR, "ERROR: rtlSetup() could not start decoder task %u, running with %u workers", started, started);
+        break;
+      }
+    }
+    _workerCount = started;
+    rtl_433_DecoderHandle = _workers[0].handle;
+    _numWorkers = started ? started : 1;
   }  
 }
 
 void rtl_433_Decoder::setCallback(rtl_433_ESPCallBack callback) {
   // logprintfLn(LOG_DEBUG, "_setCallback location: %p", callback);
 
-  r_cfg_t* cfg = &g_cfg;
+  _callback = callback;
+}
+
+void rtl_433_Decoder::setWorkers(unsigned count, int firstCore) {
+  if (g_cfg.demod) {
+    logprintfLn(LOG_ERR, "ERROR: setWorkers() after rtlSetup()");
+    return;
+  }
+  _workerCount = count;
+  _workerFirstCore = firstCore;
+}
+
+void rtl_433_Decoder::setQueue(unsigned depth, rtl_433_queue_policy_t policy, unsigned timeoutMs) {
+  if (g_cfg.demod && depth != _queueDepth) {
+    logprintfLn(LOG_ERR, "ERROR: setQueue() depth after rtlSetup()");
+  } else {
+    _queueDepth = depth ? depth : 1;
+  }
+  _queuePolicy = policy;
+  _queueTimeoutMs = timeoutMs;
+}
 
-  cfg->callback = callback;
+rtl_433_queue_stats_t rtl_433_Decoder::getQueueStats() {
+  rtl_433_queue_stats_t stats = {};
+  if (!g_cfg.demod) {
+    stats.depth = _queueDepth;
+    return stats;
+  }
+  stats.depth = _queueDepth; // the urgent lane
+  port_sem_take(_reorderLock, PORT_FOREVER);
+  for (unsigned i = 0; i < _numSources; i++) {
+    rtl_433_queue_stats_t* queue = &_sources[i].stats.queue;
+    stats.depth += queue->depth;
+    stats.enqueued += queue->enqueued;
+    stats.dropped_newest += queue->dropped_newest;
+    stats.dropped_oldest += queue->dropped_oldest;
+    stats.timeouts += queue->timeouts;
+    stats.coalesced += queue->coalesced;
+    if (queue->high_watermark > stats.high_watermark) {
+      stats.high_watermark = queue->high_watermark;
+    }
+  }
+  port_sem_give(_reorderLock);
+  return stats;
+}
+
+void rtl_433_Decoder::setSource(unsigned source, unsigned weight, unsigned depth) {
+  if (g_cfg.demod) {
+    logprintfLn(LOG_ERR, "ERROR: setSource() after rtlSetup()");
+    return;
+  }
+  if (source >= rtl_433_Decoder_Max_Sources) {
+    logprintfLn(LOG_ERR, "ERROR: setSource() source %u out of range", source);
+    return;
+  }
+  _sources[source].weight = weight ? weight : 1;
+  _sources[source].depth = depth;
+  if (source >= _numSources) {
+    _numSources = source + 1;
+  }
+}
+
+void rtl_433_Decoder::setUrgentDispatch(bool urgentFirst) {
+  __atomic_store_n(&_urgentFirst, urgentFirst, __ATOMIC_RELAXED); // read by the workers
+}
+
+int rtl_433_Decoder::setUrgentDevice(const char* name, bool urgent) {
+  int found = 0;
+  for (unsigned i = 0; i < _numWorkers; i++) {
+    found = set_device_urgent(_workers[i].cfg, name, urgent);
+  }
+  return found;
+}
+
+rtl_433_lane_stats_t rtl_433_Decoder::getLaneStats(rtl_433_lane_t lane) {
+  rtl_433_lane_stats_t stats = {};
+  if (!g_cfg.demod || lane >= RTL_433_LANES) {
+    return stats;
+  }
+  port_sem_take(_reorderLock, PORT_FOREVER);
+  stats = _laneStats[lane];
+  if (stats.delivered) {
+    stats.latency_avg_us = _laneLatencyUs[lane] / stats.delivered;
+  }
+  port_sem_give(_reorderLock);
+  return stats;
+}
+
+rtl_433_source_stats_t rtl_433_Decoder::getSourceStats(unsigned source) {
+  rtl_433_source_stats_t stats = {};
+  if (!g_cfg.demod || source >= _numSources) {
+    return stats;
+  }
+  port_sem_take(_reorderLock, PORT_FOREVER);
+  stats = _sources[source].stats;
+  port_sem_give(_reorderLock);
+  return stats;
+}
+
+void rtl_433_Decoder::setPool(unsigned pulses, unsigned packs) {
+  if (g_cfg.demod) {
+    logprintfLn(LOG_ERR, "ERROR: setPool() after rtlSetup()");
+    return;
+  }
+  _pulsePoolSize = pulses < BLOCK_POOL_MAX_BLOCKS ? pulses : BLOCK_POOL_MAX_BLOCKS;
+  _packPoolSize = packs < BLOCK_POOL_MAX_BLOCKS ? packs : BLOCK_POOL_MAX_BLOCKS;
+}
+
+rtl_433_pool_stats_t rtl_433_Decoder::getPoolStats() {
+  rtl_433_pool_stats_t stats = {};
+  block_pool_stats(&_pulsePool, &stats.pulses);
+  block_pool_stats(&_packPool, &stats.packs);
+  block_pool_stats(&_jobPool, &stats.jobs);
+  stats.heap_pulses = __atomic_load_n(&_heapPulses, __ATOMIC_RELAXED);
+  stats.heap_packs = __atomic_load_n(&_heapPacks, __ATOMIC_RELAXED);
+  stats.heap_jobs = __atomic_load_n(&_heapJobs, __ATOMIC_RELAXED);
+  stats.dropped_packs = __atomic_load_n(&_droppedPacks, __ATOMIC_RELAXED);
+  return stats;
+}
+
+/// A pulse train from the pool, or from the heap once the pool is exhausted.
+pulse_data_t* rtl_433_Decoder::newPulses() {
+  pulse_data_t* rtl_pulses = acquirePulses();
+  if (!rtl_pulses) {
+    rtl_pulses = (pulse_data_t*)port_calloc(1, sizeof(pulse_data_t));
+    if (rtl_pulses) {
+      __atomic_fetch_add(&_heapPulses, 1, __ATOMIC_RELAXED);
+    }
+  }
+  return rtl_pulses;
+}
+
+/// Free a pulse train of newPulses() or one the caller allocated.
+void rtl_433_Decoder::freePulses(pulse_data_t* rtl_pulses) {
+  if (block_pool_owns(&_pulsePool, rtl_pulses)) {
+    block_pool_release(&_pulsePool, rtl_pulses);
+  } else {
+    free(rtl_pulses);
+  }
+}
+
+/// Pack a pulse train for the queue, into the pool if it fits or the heap, nullptr if it can't be packed.
+pulse_pack_t* rtl_433_Decoder::packPulses(const pulse_data_t* rtl_pulses) {
+  unsigned words = pulse_pack_words(rtl_pulses);
+  pulse_pack_t* pack = nullptr;
+  if (words <= rtl_433_Decoder_Pack_Words) {
+    pack = (pulse_pack_t*)block_pool_acquire(&_packPool);
+  }
+  if (!pack) {
+    pack = (pulse_pack_t*)port_malloc(pulse_pack_size(words));
+    if (!pack) {
+      return nullptr;
+    }
+    __atomic_fetch_add(&_heapPacks, 1, __ATOMIC_RELAXED);
+  }
+  if (pulse_pack_encode(pack, words, rtl_pulses)) {
+    freePack(pack);
+    return nullptr;
+  }
+  return pack;
+}
+
+void rtl_433_Decoder::freePack(pulse_pack_t* pack) {
+  if (block_pool_owns(&_packPool, pack)) {
+    block_pool_release(&_packPool, pack);
+  } else {
+    free(pack);
+  }
+}
+
+decode_job_t* rtl_433_Decoder::newJob() {
+  decode_job_t* job = (decode_job_t*)block_pool_acquire(&_jobPool);
+  if (job) {
+    memset(job, 0, sizeof(decode_job_t));
+  } else {
+    job = (decode_job_t*)calloc(1, sizeof(decode_job_t));
+    if (job) {
+      __atomic_fetch_add(&_heapJobs, 1, __ATOMIC_RELAXED);
+    }
+  }
+  return job;
+}
+
+void rtl_433_Decoder::freeJob(decode_job_t* job) {
+  free(job->messages);
+  if (block_pool_owns(&_jobPool, job)) {
+    block_pool_release(&_jobPool, job);
+  } else {
+    free(job);
+  }
+}
+
+void rtl_433_Decoder::setEdgeRing(unsigned size, void* ctx, rtl_433_modulation_t modulation) {
+  if (g_cfg.demod) {
+    logprintfLn(LOG_ERR, "ERROR: setEdgeRing() after rtlSetup()");
+    return;
+  }
+  if (_edgeRing.edges) {
+    pulse_ring_free(&_edgeRing);
+    pulse_packetizer_free(&_packetizer);
+  }
+  if (pulse_ring_init(&_edgeRing, size) || pulse_packetizer_init(&_packetizer)) {
+    logprintfLn(LOG_ERR, "ERROR: setEdgeRing() out of memory");
+    pulse_ring_free(&_edgeRing);
+    pulse_packetizer_free(&_packetizer);
+    return;
+  }
+  _edgeJob.ctx = ctx;
+  _edgeJob.modulation = modulation;
+}
+
+rtl_433_edge_stats_t rtl_433_Decoder::getEdgeStats() {
+  rtl_433_edge_stats_t stats = {};
+  stats.packages = _packetizer.packages;
+  stats.short_trains = _packetizer.short_trains;
+  stats.broken_trains = _packetizer.broken_trains;
+  stats.overflows = _edgeRing.overflows;
+  return stats;
+}
+
+void rtl_433_Decoder::setParallelDispatch(unsigned parts) {
+  if (g_cfg.demod) {
+    logprintfLn(LOG_ERR, "ERROR: setParallelDispatch() after rtlSetup()");
+    return;
+  }
+  _dispatchParts = parts < 1 ? 1 : parts > DISPATCH_MAX_PARTS ? DISPATCH_MAX_PARTS : parts;
+}
+
+void rtl_433_Decoder::setAdaptiveOrder(bool adaptive, bool firstHitStop, bool costAware) {
+  _adaptiveOrder = adaptive;
+  _firstHitStop = firstHitStop;
+  _costAware = costAware;
+  for (unsigned i = 0; i < _numWorkers; i++) {
+    set_adaptive_order(_workers[i].cfg, adaptiveOrderMode(), _firstHitStop);
+  }
+}
+
+void rtl_433_Decoder::setFingerprintCache(unsigned slots) {
+  _fingerprintCacheSlots = slots;
+  for (unsigned i = 0; i < _numWorkers; i++) {
+    set_fingerprint_cache(_workers[i].cfg, _fingerprintCacheSlots);
+  }
+}
+
+void rtl_433_Decoder::setDemotionPolicy(unsigned afterRuns, unsigned sample) {
+  _demoteAfterRuns = afterRuns;
+  _demoteSample = sample;
+  for (unsigned i = 0; i < _numWorkers; i++) {
+    set_demotion_policy(_workers[i].cfg, _demoteAfterRuns, _demoteSample);
+  }
+}
+
+void rtl_433_Decoder::setDecodeBudget(unsigned budgetUs) {
+  _decodeBudgetUs = budgetUs;
+  for (unsigned i = 0; i < _numWorkers; i++) {
+    set_decode_budget(_workers[i].cfg, _decodeBudgetUs);
+  }
+}
+
+/// The configs of all workers, for the reports covering all of them.
+std::vector<r_cfg_t*> rtl_433_Decoder::workerConfigs() {
+  std::vector<r_cfg_t*> cfgs(_numWorkers);
+  for (unsigned i = 0; i < _numWorkers; i++) {
+    cfgs[i] = _workers[i].cfg;
+  }
+  return cfgs;
+}
+
+char* rtl_433_Decoder::getDispatchReport() {
+  if (!g_cfg.demod) {
+    return nullptr;
+  }
+  // a string that does not fit is left out and the room only shrinks, so once the room left at the end
+  // holds the longest name, escaped, and a number, nothing was left out
+  size_t longest = 0;
+  list_t* r_devs = &g_cfg.demod->r_devs;
+  for (size_t i = 0; i < r_devs->len; i++) {
+    size_t len = strlen(((r_device*)r_devs->elems[i])->name);
+    if (len > longest) {
+      longest = len;
+    }
+  }
+  std::vector<r_cfg_t*> cfgs = workerConfigs();
+  data_t* data = create_dispatch_report(cfgs.data(), cfgs.size());
+  size_t message_size = 2000;
+  char* message = nullptr;
+  for (;;) {
+    char* grown = (char*)realloc(message, message_size);
+    if (!grown) {
+      logprintfLn(LOG_ERR, "ERROR: getDispatchReport() out of memory");
+      free(message);
+      data_free(data);
+      return nullptr;
+    }
+    message = grown;
+    if (message_size - data_print_jsons(data, message, message_size) > 2 * longest + 16) {
+      break;
+    }
+    message_size *= 2;
+  }
+  data_free(data);
+  return message;
+}
+
+dispatch_stats_t rtl_433_Decoder::getDispatchStats() {
+  dispatch_stats_t stats = {};
+  for (unsigned i = 0; i < _numWorkers; i++) {
+    add_dispatch_stats(_workers[i].cfg, &stats);
+  }
+  return stats;
+}
+
+unsigned rtl_433_Decoder::getDecoderStats(decoder_stats_t* stats, unsigned count) {
+  if (!g_cfg.demod) {
+    return 0;
+  }
+  if (!stats) {
+    count = 0;
+  }
+  for (unsigned read = 1;; read++) {
+    if (count) {
+      memset(stats, 0, count * sizeof(decoder_stats_t));
+    }
+    int registered = 0;
+    bool consistent = true;
+    for (unsigned i = 0; i < _numWorkers; i++) {
+      int workerRegistered = add_decoder_stats(_workers[i].cfg, stats, count);
+      if (workerRegistered < 0) {
+        consistent = false;
+      } else {
+        registered = workerRegistered;
+      }
+    }
+    if (consistent) {
+      return registered;
+    }
+    if (read == rtl_433_Decoder_Stats_Reads) {
+      logprintfLn(LOG_ERR, "ERROR: getDecoderStats() counters kept changing, no consistent read");
+      return 0;
+    }
+    // the updating task may be preempted by this one on the same core, let it finish the update
+    port_delay_ms(1);
+  }
+}
+
+size_t rtl_433_Decoder::saveDispatchModel(void* buf, size_t size) {
+  if (!g_cfg.demod) {
+    return 0;
+  }
+  std::vector<r_cfg_t*> cfgs = workerConfigs();
+  return save_dispatch_model(cfgs.data(), cfgs.size(), buf, size);
+}
+
+int rtl_433_Decoder::loadDispatchModel(const void* buf, size_t size) {
+  if (!g_cfg.demod) {
+    logprintfLn(LOG_ERR, "ERROR: loadDispatchModel() before rtlSetup()");
+    return -1;
+  }
+  int restored = load_dispatch_model(&g_cfg, buf, size);
+  for (unsigned i = 1; i < _numWorkers; i++) {
+    load_dispatch_model(_workers[i].cfg, buf, size);
+  }
+  if (restored < 0) {
+    logprintfLn(LOG_ERR, "ERROR: loadDispatchModel() invalid model");
+  }
+  return restored;
 }
 
 // ---------------------------------------------------------------------------------------------------------
 
+int rtl_433_Decoder::runDemods(decode_worker_t* worker, bool ook, pulse_data_t* pulses) {
+  struct dm_state* demod = worker->cfg->demod;
+  if (worker->num_parts > 1) {
+    return ook ? run_ook_demods_split(demod, worker->slicers, worker->num_parts, workerFork, worker, pulses)
+               : run_fsk_demods_split(demod, worker->slicers, worker->num_parts, workerFork, worker, pulses);
+  }
+  return ook ? run_ook_demods(demod, worker->slicers[0], pulses) : run_fsk_demods(demod, worker->slicers[0], pulses);
+}
+
+/// Merge barrier of the parallel dispatch: run the other partitions on the helpers, the first one here,
+/// and return once all of them are done.
+void rtl_433_Decoder::workerFork(void* fork_ctx, void (*fn)(void* arg, unsigned part), void* arg, unsigned num_parts) {
+  decode_worker_t* worker = (decode_worker_t*)fork_ctx;
+  worker->partFn = fn;
+  worker->partArg = arg;
+  for (unsigned part = 1; part < num_parts; part++) {
+    port_sem_give(worker->helpers[part - 1].start);
+  }
+  fn(arg, 0);
+  for (unsigned part = 1; part < num_parts; part++) {
+    port_sem_take(worker->done, PORT_FOREVER);
+  }
+}
+
+void rtl_433_Decoder::rtl_433_HelperTask(void* pvParameters) {
+  decode_helper_t* helper = (decode_helper_t*)pvParameters;
+  decode_worker_t* worker = helper->worker;
+
+  for (;;) {
+    port_sem_take(helper->start, PORT_FOREVER);
+    worker->partFn(worker->partArg, helper->part);
+    port_sem_give(worker->done);
+  }
+}
+
+/// Decode a signal with the slicer family the job asks for, collecting the messages on the job.
+int rtl_433_Decoder::decodeJob(decode_worker_t* worker, decode_job_t* job, pulse_data_t* pulses) {
+  pulses->sample_rate = 1.0e6;
+  worker->job = job;
+  worker->cfg->source = job->source;
+  worker->cfg->signal_us = job->submitted;
+  set_urgent_signal(worker->cfg, __atomic_load_n(&_urgentFirst, __ATOMIC_RELAXED) && job->lane == RTL_433_LANE_URGENT);
+  int events = 0;
+
+  bool ook = _ookModulation;
+  bool fallback = false;
+  if (job->modulation == RTL_433_MODULATION_OOK) {
+    ook = true;
+  } else if (job->modulation == RTL_433_MODULATION_FSK) {
+    ook = false;
+  } else if (job->modulation == RTL_433_MODULATION_AUTO) {
+    pulse_hist_family_t family = pulse_hist_classify(pulses);
+    if (family != PULSE_HIST_UNKNOWN) {
+      ook = family == PULSE_HIST_OOK;
+    }
+    fallback = true;
+  }
+
+  // todo: put back in optional basic memory heap/stack debug logging
+  events = runDemods(worker, ook, pulses);
+  if (events == 0 && fallback) {
+    events = runDemods(worker, !ook, pulses);
+  }
+
+  worker->job = nullptr;
+  job->events = events;
+  return events;
+}
+
+/// Decode the pulse trains completed in the edge ring, delivering them right away.
+/// Edge trains bypass the reorder stage, they are not ordered against the queued signals.
+void rtl_433_Decoder::drainEdges(decode_worker_t* worker) {
+  pulse_data_t* pulses;
+  while ((pulses = pulse_packetizer_run(&_packetizer, &_edgeRing, (uint32_t)port_now_us())) != nullptr) {
+    _edgeJob.submitted = port_now_us();
+    decodeJob(worker, &_edgeJob, pulses);
+    port_sem_take(_reorderLock, PORT_FOREVER);
+    deliverJob(&_edgeJob);
+    port_sem_give(_reorderLock);
+  }
+}
+
+/// Take the next urgent signal, or else the next signal by smooth weighted round-robin over the sources with signals waiting.
+/// Each waiting source earns its weight in credit, the richest goes and pays the total earned.
+decode_job_t* rtl_433_Decoder::nextJob() {
+  decode_job_t* job = nullptr;
+  if (port_queue_receive(_urgentQueue, &job, 0)) {
+    return job;
+  }
+  port_sem_take(_sourceLock, PORT_FOREVER);
+  decode_source_t* next = nullptr;
+  int earned = 0;
+  for (unsigned i = 0; i < _numSources; i++) {
+    decode_source_t* source = &_sources[i];
+    if (port_queue_waiting(source->queue) == 0) {
+      continue;
+    }
+    source->credit += source->stats.weight;
+    earned += source->stats.weight;
+    if (!next || source->credit > next->credit) {
+      next = source;
+    }
+  }
+  if (next && port_queue_receive(next->queue, &job, 0)) {
+    next->credit -= earned;
+  }
+  port_sem_give(_sourceLock);
+  return job;
+}
+
 void rtl_433_Decoder::rtl_433_DecoderTask(void* pvParameters) {
-  rtl_433_Decoder* thistask= (rtl_433_Decoder *) pvParameters; 
-  r_cfg_t* cfg = &thistask->g_cfg;
+  decode_worker_t* worker = (decode_worker_t*) pvParameters;
+  rtl_433_Decoder* thistask = worker->decoder;
   decode_job_t* job;
 
+  bool edges = thistask->_edgeRing.edges && worker == thistask->_workers;
+  uint32_t wait = edges ? rtl_433_Decoder_Edge_Poll_MS : PORT_FOREVER;
+
   for (;;) {
+    if (edges) {
+      port_sem_take(worker->stateLock, PORT_FOREVER);
+      thistask->drainEdges(worker);
+      port_sem_give(worker->stateLock);
+    }
 //    logprintfLn(LOG_DEBUG, "rtl_433_DecoderTask awaiting signal");
-    xQueueReceive(thistask->rtl_433_Queue, &job, portMAX_DELAY);
+    if (!port_sem_take(thistask->_jobsReady, wait)) {
+      continue;
+    }
+    job = thistask->nextJob();
+    if (!job) {
+      continue; // taken from its queue to make room, see RTL_433_QUEUE_DROP_OLDEST
+    }
     // logprintfLn(LOG_DEBUG, "rtl_433_DecoderTask signal received");
 
-    job->rtl_pulses->sample_rate = 1.0e6;
-    cfg->ctx=job->ctx;
-    int events = 0;
+    if (worker->stateLock) {
+      port_sem_take(worker->stateLock, PORT_FOREVER);
+    }
+    pulse_pack_decode(job->pack, worker->pulses);
+    thistask->decodeJob(worker, job, worker->pulses);
+    if (worker->stateLock) {
+      port_sem_give(worker->stateLock);
+    }
+    thistask->freePack(job->pack);
+    job->pack = nullptr;
+    thistask->commitJob(job);
+  }
+}
 
-    // todo: put back in optional basic memory heap/stack debug logging
-    if (thistask->_ookModulation) {
-      events = run_ook_demods(&cfg->demod->r_devs, job->rtl_pulses);
+/// Output callback of the worker configs, holds the message back until the job is delivered.
+void rtl_433_Decoder::workerOutput(char* message, void* ctx) {
+  decode_worker_t* worker = (decode_worker_t*)ctx;
+  decode_job_t* job = worker->job;
+  if (worker->outputLock) {
+    port_sem_take(worker->outputLock, PORT_FOREVER);
+  }
+  if (job->num_messages == job->max_messages) {
+    unsigned max_messages = job->max_messages ? job->max_messages * 2 : 4;
+    char** messages = (char**)realloc(job->messages, max_messages * sizeof(char*));
+    if (!messages) {
+      logprintfLn(LOG_ERR, "ERROR: workerOutput() out of memory, discarding message");
+      free(message);
+      message = nullptr;
     } else {
-      events = run_fsk_demods(&cfg->demod->r_devs, job->rtl_pulses);
+      job->messages = messages;
+      job->max_messages = max_messages;
     }
+  }
+  if (message) {
+    job->messages[job->num_messages++] = message;
+  }
+  if (worker->outputLock) {
+    port_sem_give(worker->outputLock);
+  }
+}
 
-    if (events == 0) {
-      thistask->unparsedSignals++;
+/// Hand the messages of a decoded job to the callback, called with the reorder lock held.
+void rtl_433_Decoder::deliverJob(decode_job_t* job) {
+  for (unsigned i = 0; i < job->num_messages; i++) {
+    if (_callback) {
+      _callback(job->messages[i], job->ctx);
+    } else {
+      free(job->messages[i]);
     }
+  }
+  job->num_messages = 0;
+  if (job->events == 0) {
+    unparsedSignals++;
+  }
+}
 
-    free(job->rtl_pulses);
-    free(job);
+/// Reorder stage: park a finished job, then deliver all jobs that are next in submission order.
+void rtl_433_Decoder::commitJob(decode_job_t* job) {
+  port_sem_take(_reorderLock, PORT_FOREVER);
+  _reorderSlots[job->seq & (_reorderWindow - 1)] = job;
+  while ((job = _reorderSlots[_deliverSeq & (_reorderWindow - 1)]) != nullptr) {
+    _reorderSlots[_deliverSeq & (_reorderWindow - 1)] = nullptr;
+    _deliverSeq++;
+
+    if (job->events >= 0) {
+      _sources[job->source].stats.decoded++;
+      _sources[job->source].stats.events += job->events;
+
+      rtl_433_lane_stats_t* lane = &_laneStats[job->lane];
+      unsigned latency = port_now_us() - job->submitted;
+      lane->delivered++;
+      _laneLatencyUs[job->lane] += latency;
+      if (latency > lane->latency_max_us) {
+        lane->latency_max_us = latency;
+      }
+    }
+    deliverJob(job);
+    freeJob(job);
+    port_sem_give(_reorderRoom);
+  }
+  port_sem_give(_reorderLock);
+}
 
+/// Hash of the pulse timing rounded to 64 us, equal for repeats of a transmission. The trailing gap is left out.
+static uint32_t signalSignature(const pulse_pack_t* pack) {
+  uint32_t hash = 2166136261u ^ (uint32_t)pack->num_pulses;
+  unsigned pos = 0;
+  for (unsigned i = 0; i < pack->num_pulses; i++) {
+    hash = (hash ^ (uint32_t)((pulse_pack_next(pack, &pos) + 32) >> 6)) * 16777619u;
+    unsigned gap = pulse_pack_next(pack, &pos);
+    if (i + 1 < pack->num_pulses) {
+      hash = (hash ^ (uint32_t)((gap + 32) >> 6)) * 16777619u;
+    }
   }
+  return hash;
 }
 
-void rtl_433_Decoder::processSignal(pulse_data_t* rtl_pulses,void* ctx) {
-    decode_job_t *job=(decode_job_t*) malloc (sizeof(decode_job_t));
-    job->rtl_pulses=rtl_pulses;
-    job->ctx=ctx;
+/// Drop a job that already has its seq, the reorder stage still has to see it.
+void rtl_433_Decoder::discardJob(decode_job_t* job) {
+  freePack(job->pack);
+  job->pack = nullptr;
+  job->events = -1;
+  commitJob(job);
+}
+
+void rtl_433_Decoder::processSignal(pulse_data_t* rtl_pulses,void* ctx,rtl_433_modulation_t modulation,unsigned source,rtl_433_lane_t lane) {
+  if (!_workerCount) {
+    processSignalSync(rtl_pulses, ctx, modulation, source);
+    freePulses(rtl_pulses);
+    return;
+  }
+
+  if (source >= _numSources) {
+    logprintfLn(LOG_ERR, "ERROR: processSignal() unknown source %u, discarding signal", source);
+    freePulses(rtl_pulses);
+    return;
+  }
+  // the full pulse train is given back right away, the signal waits packed
+  pulse_pack_t* pack = packPulses(rtl_pulses);
+  freePulses(rtl_pulses);
+  if (!pack) {
+    __atomic_fetch_add(&_droppedPacks, 1, __ATOMIC_RELAXED);
+    logprintfLn(LOG_ERR, "ERROR: processSignal() out of memory or signal too long, discarding signal");
+    return;
+  }
+
+  int64_t submitted = port_now_us();
+  decode_source_t* src = &_sources[source];
+  port_queue_t queue = lane == RTL_433_LANE_URGENT ? _urgentQueue : src->queue;
+  rtl_433_queue_stats_t* stats = &src->stats.queue;
+  rtl_433_queue_policy_t policy = _queuePolicy;
+  uint32_t wait = policy == RTL_433_QUEUE_BLOCK ? _queueTimeoutMs : 0;
+  // the urgent queue is shared by all sources and never coalesced, only the normal lane keeps a signature
+  bool coalesce = policy == RTL_433_QUEUE_COALESCE && lane != RTL_433_LANE_URGENT;
+  uint32_t signature = coalesce ? signalSignature(pack) : 0;
+
+  if (coalesce) {
+    // the last queued signal of the source is still waiting as long as its queue is not empty
+    port_sem_take(_reorderLock, PORT_FOREVER);
+    bool repeat = signature == src->lastSignature && port_queue_waiting(queue) > 0;
+    if (repeat) {
+      stats->coalesced++;
+    }
+    port_sem_give(_reorderLock);
+    if (repeat) {
+      freePack(pack);
+      return;
+    }
+  }
+
+  bool room = port_sem_take(_reorderRoom, wait);
+  if (!room && policy == RTL_433_QUEUE_DROP_OLDEST) {
+    decode_job_t* oldest;
+    if (port_queue_receive(queue, &oldest, 0)) {
+      port_sem_take(_jobsReady, 0);
+      discardJob(oldest);
+      port_sem_take(_reorderLock, PORT_FOREVER);
+      stats->dropped_oldest++;
+      port_sem_give(_reorderLock);
+      room = port_sem_take(_reorderRoom, 0);
+    }
+  }
+  if (!room) {
+    logprintfLn(LOG_ERR, "ERROR: rtl_433 reorder window full, discarding signal");
+    port_sem_take(_reorderLock, PORT_FOREVER);
+    if (policy == RTL_433_QUEUE_BLOCK) {
+      stats->timeouts++;
+    } else {
+      stats->dropped_newest++;
+    }
+    port_sem_give(_reorderLock);
+    freePack(pack);
+    return;
+  }
 
+  decode_job_t *job=newJob();
+  if (!job) {
+    logprintfLn(LOG_ERR, "ERROR: processSignal() out of memory, discarding signal");
+    port_sem_give(_reorderRoom);
+    freePack(pack);
+    return;
+  }
+  job->pack=pack;
+  job->ctx=ctx;
+  job->modulation=modulation;
+  job->source=source;
+  job->lane=lane == RTL_433_LANE_URGENT ? RTL_433_LANE_URGENT : RTL_433_LANE_NORMAL;
+  job->submitted=submitted;
+
+  port_sem_take(_reorderLock, PORT_FOREVER);
+  job->seq = _submitSeq++;
+  if (job->lane == RTL_433_LANE_NORMAL) {
+    src->lastSignature = signature;
+  }
+  port_sem_give(_reorderLock);
+
+  // the lock is not held while waiting, so workers keep delivering
   // logprintfLn(LOG_DEBUG, "processSignal() about to place signal on
   // rtl_433_Queue");
-  if (xQueueSend(rtl_433_Queue, &job, 0) != pdTRUE) {
-    logprintfLn(LOG_ERR, "ERROR: rtl_433_Queue full, discarding signal");
-    free(rtl_pulses);
-    free(job);
+  uint32_t waited = (port_now_us() - submitted) / 1000;
+  bool sent = port_queue_send(queue, &job, waited < wait ? wait - waited : 0);
+  bool evicted = false;
+  if (!sent && policy == RTL_433_QUEUE_DROP_OLDEST) {
+    decode_job_t* oldest;
+    if (port_queue_receive(queue, &oldest, 0)) {
+      port_sem_take(_jobsReady, 0);
+      discardJob(oldest);
+      evicted = true;
+    }
+    sent = port_queue_send(queue, &job, 0);
+  }
+
+  port_sem_take(_reorderLock, PORT_FOREVER);
+  if (evicted) {
+    stats->dropped_oldest++;
+  }
+  if (sent) {
+    port_sem_give(_jobsReady);
+    stats->enqueued++;
+    unsigned waiting = port_queue_waiting(queue);
+    if (waiting > stats->high_watermark) {
+      stats->high_watermark = waiting;
+    }
+  } else if (policy == RTL_433_QUEUE_BLOCK) {
+    stats->timeouts++;
+  } else {
+    stats->dropped_newest++;
+  }
+  port_sem_give(_reorderLock);
+
+  if (!sent) {
+    logprintfLn(LOG_ERR, "ERROR: rtl_433 queue of source %u full, discarding signal", source);
+    discardJob(job); // keep the sequence without gaps
   } else {
     //logprintfLn(LOG_DEBUG, "processSignal() signal placed on rtl_433_Queue");
   }
 }
 
-void rtl_433_Decoder::processRaw(const std::vector<int32_t> &rawdata,void* ctx) {
-  pulse_data_t* rtl_pulses = (pulse_data_t*)heap_caps_calloc(1, sizeof(pulse_data_t), MALLOC_CAP_INTERNAL);
+/// Deliver the messages of a job decoded on the caller's thread.
+int rtl_433_Decoder::deliverSync(decode_job_t* job) {
+  port_sem_take(_reorderLock, PORT_FOREVER);
+  deliverJob(job);
+  port_sem_give(_reorderLock);
+  free(job->messages);
+  job->messages = nullptr;
+  return job->events;
+}
+
+int rtl_433_Decoder::processSignalSync(pulse_data_t* rtl_pulses, void* ctx, rtl_433_modulation_t modulation, unsigned source) {
+  if (!g_cfg.demod) {
+    logprintfLn(LOG_ERR, "ERROR: processSignalSync() before rtlSetup()");
+    return -1;
+  }
+  decode_job_t job = {};
+  job.ctx = ctx;
+  job.modulation = modulation;
+  job.source = source;
+  job.submitted = port_now_us();
+
+  port_sem_take(_workers[0].stateLock, PORT_FOREVER);
+  decodeJob(&_workers[0], &job, rtl_pulses);
+  port_sem_give(_workers[0].stateLock);
+  return deliverSync(&job);
+}
+
+/// Convert mark/space durations, a mark without a following space gets a 10 ms gap.
+static void rawToPulses(const std::vector<int32_t> &rawdata, pulse_data_t* rtl_pulses) {
   int maxsize = sizeof(rtl_pulses->pulse) / sizeof(*rtl_pulses->pulse);
   int rawcount=rawdata.size();
   int i=0;
@@ -141,16 +981,278 @@ void rtl_433_Decoder::processRaw(const std::vector<int32_t> &rawdata,void* ctx)
   }
 
   rtl_pulses->num_pulses=i;
+}
+
+void rtl_433_Decoder::processRaw(const std::vector<int32_t> &rawdata,void* ctx,rtl_433_modulation_t modulation,unsigned source,rtl_433_lane_t lane) {
+  pulse_data_t* rtl_pulses = newPulses();
+  if (!rtl_pulses) {
+    logprintfLn(LOG_ERR, "ERROR: processRaw() out of memory, discarding signal");
+    return;
+  }
+  rawToPulses(rawdata, rtl_pulses);
 
-  processSignal(rtl_pulses,ctx);
+  processSignal(rtl_pulses,ctx,modulation,source,lane);
 }
 
-void rtl_433_Decoder::processRFRaw(char const *p,void* ctx) {
-  pulse_data_t* rtl_pulses = (pulse_data_t*)heap_caps_calloc(1, sizeof(pulse_data_t), MALLOC_CAP_INTERNAL);
+int rtl_433_Decoder::processRawSync(const std::vector<int32_t> &rawdata, void* ctx, rtl_433_modulation_t modulation, unsigned source) {
+  if (!g_cfg.demod) {
+    logprintfLn(LOG_ERR, "ERROR: processRawSync() before rtlSetup()");
+    return -1;
+  }
+  decode_job_t job = {};
+  job.ctx = ctx;
+  job.modulation = modulation;
+  job.source = source;
+  job.submitted = port_now_us();
+
+  // the pulse buffer is reused, it is only touched with the decoder state held
+  port_sem_take(_workers[0].stateLock, PORT_FOREVER);
+  if (!_syncPulses) {
+    _syncPulses = (pulse_data_t*)port_malloc(sizeof(pulse_data_t));
+    if (!_syncPulses) {
+      port_sem_give(_workers[0].stateLock);
+      logprintfLn(LOG_ERR, "ERROR: processRawSync() out of memory");
+      return -1;
+    }
+  }
+  clearPulses(_syncPulses);
+  rawToPulses(rawdata, _syncPulses);
+  decodeJob(&_workers[0], &job, _syncPulses);
+  port_sem_give(_workers[0].stateLock);
+  return deliverSync(&job);
+}
+
+void rtl_433_Decoder::processRFRaw(char const *p,void* ctx,rtl_433_modulation_t modulation,unsigned source,rtl_433_lane_t lane) {
+  pulse_data_t* rtl_pulses = newPulses();
+  if (!rtl_pulses) {
+    logprintfLn(LOG_ERR, "ERROR: processRFRaw() out of memory, discarding signal");
+    return;
+  }
 
   if (rfraw_parse(rtl_pulses,p)) {
-    processSignal(rtl_pulses,ctx);
+    processSignal(rtl_pulses,ctx,modulation,source,lane);
   } else {
-    free(rtl_pulses);
+    freePulses(rtl_pulses);
+  }
+}
+
+// Unit testing of the queue policies, on the pthread port:
+//   gcc -c the sources of src/rtl_433 with -ffunction-sections, then
+//   g++ -D_TEST -Iinclude -Isrc src/signalDecoder.cpp src/decoderPort.cpp *.o -Wl,--gc-sections -lpthread -lm
+#ifdef _TEST
+#define ASSERT_EQUALS(a, b) \
+  do { \
+    if ((a) == (b)) \
+      ++passed; \
+    else { \
+      ++failed; \
+      fprintf(stderr, "FAIL: line %d: %d <> %d\n", __LINE__, (int)(a), (int)(b)); \
+    } \
+  } while (0)
+
+static port_sem_t testEntered;
+static port_sem_t testRelease;
+static port_sem_t testTick;
+static int testHeld;
+
+/// Stands in for every decoder, holds the worker on the first call until released.
+static int testGate(r_device*, bitbuffer_t*) {
+  if (!__atomic_exchange_n(&testHeld, 1, __ATOMIC_ACQ_REL)) {
+    port_sem_give(testEntered);
+    port_sem_take(testRelease, PORT_FOREVER);
+  }
+  return DECODE_ABORT_EARLY;
+}
+
+static void testOutput(char* message, void*) {
+  free(message);
+}
+
+/// A repeated PWM frame, seed changes the gaps and so the signature.
+static std::vector<int32_t> testSignal(int seed) {
+  static const unsigned char bits[5] = {0x5a, 0x3c, 0x12, 0xf0, 0x70};
+  std::vector<int32_t> raw;
+  for (int r = 0; r < 6; r++) {
+    for (int i = 0; i < 36; i++) {
+      raw.push_back(500);
+      raw.push_back((bits[i / 8] >> (7 - i % 8) & 1 ? -2000 : -1000) - seed * 256);
+    }
+    raw.push_back(500);
+    raw.push_back(-4000);
+  }
+  raw.back() = -20000;
+  return raw;
+}
+
+/// Keep the only worker busy on a signal, the following ones wait in the queues.
+static bool testHold(rtl_433_Decoder& rd) {
+  __atomic_store_n(&testHeld, 0, __ATOMIC_RELEASE);
+  rd.processRaw(testSignal(0), nullptr, RTL_433_MODULATION_OOK);
+  return port_sem_take(testEntered, 1000);
+}
+
+/// Release the worker and wait until every signal was delivered or discarded.
+static void testDrain(rtl_433_Decoder& rd) {
+  port_sem_give(testRelease);
+  while (rd.getPoolStats().jobs.in_use) {
+    port_sem_take(testTick, 1);
+  }
+}
+
+/// Check that a JSON text is one object with balanced brackets, strings closed and nothing after it.
+static bool testJsonComplete(const char* json) {
+  int depth = 0;
+  bool inString = false;
+  if (*json != '{') {
+    return false;
+  }
+  for (; *json; json++) {
+    if (inString) {
+      if (*json == '\\' && json[1]) {
+        json++;
+      } else if (*json == '"') {
+        inString = false;
+      }
+    } else if (*json == '"') {
+      inString = true;
+    } else if (*json == '{' || *json == '[') {
+      depth++;
+    } else if (*json == '}' || *json == ']') {
+      if (--depth == 0) {
+        return !inString && !json[1];
+      }
+    }
+  }
+  return false;
+}
+
+/// Count the occurrences of a key in a JSON text.
+static unsigned testJsonKeys(const char* json, const char* key) {
+  unsigned count = 0;
+  for (const char* at = strstr(json, key); at; at = strstr(at + 1, key)) {
+    count++;
+  }
+  return count;
+}
+
+int main(void) {
+  unsigned passed = 0;
+  unsigned failed = 0;
+  rtl_433_queue_stats_t before, after;
+
+  fprintf(stderr, "signalDecoder:: test\n");
+
+  testEntered = port_sem_create(1, 0);
+  testRelease = port_sem_create(1, 0);
+  testTick = port_sem_create(1, 0);
+  rtl_433_Decoder rd;
+  rd.setCallback(testOutput);
+  rd.setWorkers(1);
+  rd.setQueue(2, RTL_433_QUEUE_DROP_NEWEST);
+  rd.rtlSetup();
+  list_t* devs = &rd.g_cfg.demod->r_devs;
+  for (size_t i = 0; i < devs->len; i++) {
+    ((r_device*)devs->elems[i])->decode_fn = testGate;
+  }
+
+  fprintf(stderr, "signalDecoder:: RTL_433_QUEUE_DROP_NEWEST discards the signal that does not fit\n");
+  ASSERT_EQUALS(testHold(rd), true);
+  before = rd.getQueueStats();
+  for (int seed = 1; seed <= 3; seed++) {
+    rd.processRaw(testSignal(seed), nullptr, RTL_433_MODULATION_OOK);
+  }
+  after = rd.getQueueStats();
+  testDrain(rd);
+  ASSERT_EQUALS(after.enqueued - before.enqueued, 2);
+  ASSERT_EQUALS(after.dropped_newest - before.dropped_newest, 1);
+  ASSERT_EQUALS(after.dropped_oldest - before.dropped_oldest, 0);
+
+  fprintf(stderr, "signalDecoder:: RTL_433_QUEUE_DROP_OLDEST discards the oldest waiting signal\n");
+  rd.setQueue(2, RTL_433_QUEUE_DROP_OLDEST);
+  ASSERT_EQUALS(testHold(rd), true);
+  before = rd.getQueueStats();
+  for (int seed = 1; seed <= 3; seed++) {
+    rd.processRaw(testSignal(seed), nullptr, RTL_433_MODULATION_OOK);
+  }
+  after = rd.getQueueStats();
+  testDrain(rd);
+  ASSERT_EQUALS(after.enqueued - before.enqueued, 3);
+  ASSERT_EQUALS(after.dropped_oldest - before.dropped_oldest, 1);
+  ASSERT_EQUALS(after.dropped_newest - before.dropped_newest, 0);
+
+  fprintf(stderr, "signalDecoder:: RTL_433_QUEUE_BLOCK waits for the timeout, then discards\n");
+  rd.setQueue(2, RTL_433_QUEUE_BLOCK, 20);
+  ASSERT_EQUALS(testHold(rd), true);
+  before = rd.getQueueStats();
+  for (int seed = 1; seed <= 2; seed++) {
+    rd.processRaw(testSignal(seed), nullptr, RTL_433_MODULATION_OOK);
   }
+  int64_t start = port_now_us();
+  rd.processRaw(testSignal(3), nullptr, RTL_433_MODULATION_OOK);
+  int64_t blocked = port_now_us() - start;
+  after = rd.getQueueStats();
+  testDrain(rd);
+  ASSERT_EQUALS(after.enqueued - before.enqueued, 2);
+  ASSERT_EQUALS(after.timeouts - before.timeouts, 1);
+  ASSERT_EQUALS(after.dropped_newest - before.dropped_newest, 0);
+  ASSERT_EQUALS(blocked >= 20000, true);
+
+  fprintf(stderr, "signalDecoder:: RTL_433_QUEUE_COALESCE discards a waiting repeat, per lane\n");
+  rd.setQueue(2, RTL_433_QUEUE_COALESCE);
+  ASSERT_EQUALS(testHold(rd), true);
+  before = rd.getQueueStats();
+  rd.processRaw(testSignal(1), nullptr, RTL_433_MODULATION_OOK);
+  rd.processRaw(testSignal(2), nullptr, RTL_433_MODULATION_OOK, 0, RTL_433_LANE_URGENT);
+  rd.processRaw(testSignal(1), nullptr, RTL_433_MODULATION_OOK); // repeat of the last normal signal
+  rd.processRaw(testSignal(2), nullptr, RTL_433_MODULATION_OOK, 0, RTL_433_LANE_URGENT); // urgent, kept
+  after = rd.getQueueStats();
+  testDrain(rd);
+  ASSERT_EQUALS(after.enqueued - before.enqueued, 3);
+  ASSERT_EQUALS(after.coalesced - before.coalesced, 1);
+  ASSERT_EQUALS(after.dropped_newest - before.dropped_newest, 0);
+
+  fprintf(stderr, "signalDecoder:: getDecoderStats() fails rather than returning counters torn by an update\n");
+  static decoder_stats_t stats[1000];
+  r_device* first = (r_device*)devs->elems[0];
+  ASSERT_EQUALS(rd.getDecoderStats(stats, 1000), devs->len);
+  first->stats_seq++; // an update that never finishes
+  ASSERT_EQUALS(rd.getDecoderStats(stats, 1000), 0);
+  ASSERT_EQUALS(rd.getDecoderStats(nullptr, 0), devs->len);
+  first->stats_seq++;
+  ASSERT_EQUALS(rd.getDecoderStats(stats, 1000), devs->len);
+
+  fprintf(stderr, "signalDecoder:: acquirePulses() hands out a reused pulse train cleared\n");
+  pulse_data_t* pulses = rd.acquirePulses();
+  ASSERT_EQUALS(pulses != nullptr, true);
+  if (pulses) {
+    memset(pulses, 0xff, sizeof(pulse_data_t));
+    rd.releasePulses(pulses);
+    ASSERT_EQUALS(rd.acquirePulses() == pulses, true);
+    ASSERT_EQUALS(pulses->num_pulses, 0);
+    ASSERT_EQUALS(pulses->sample_rate, 0);
+    ASSERT_EQUALS(pulses->ook_low_estimate, 0);
+    ASSERT_EQUALS(pulses->signalRssi, 0);
+    ASSERT_EQUALS(pulses->signalDuration, 0);
+    rd.releasePulses(pulses);
+  }
+
+  fprintf(stderr, "signalDecoder:: the dispatch report of every decoder demoted is complete JSON\n");
+  dm_state* demod = rd.g_cfg.demod;
+  for (unsigned i = 0; i < demod->num_devs; i++) {
+    demod->devs[i].demoted = 1;
+    demod->devs[i].budget_skips = 1;
+  }
+  char* report = rd.getDispatchReport();
+  ASSERT_EQUALS(report != nullptr, true);
+  if (report) {
+    ASSERT_EQUALS(testJsonComplete(report), true);
+    ASSERT_EQUALS(testJsonKeys(report, "\"demoted\":1"), devs->len);
+    ASSERT_EQUALS(devs->len > 20, true);
+    free(report);
+  }
+
+  fprintf(stderr, "signalDecoder:: test (%u/%u) passed, (%u) failed.\n", passed, passed + failed, failed);
+
+  return failed;
 }
+#endif /* _TEST */
@@ -26,22 +26,33 @@
 #ifndef rtl_433_DECODER_H
 #define rtl_433_DECODER_H
 
-#include <freertos/FreeRTOS.h>
-#include <freertos/queue.h>
-#include <freertos/task.h>
+#include "decoderPort.h"
 
 // Decoder task settings
 #define rtl_433_Decoder_Priority 2
 #define rtl_433_Decoder_Core     1
+#define rtl_433_Decoder_Queue_Length 5 // default depth, see setQueue()
+#define rtl_433_Decoder_Max_Sources 4 // receivers feeding one decoder, see setSource()
+#define rtl_433_Decoder_Urgent_Devices "DSC Security Contact", "DSC Security Contact (WS4945)", \
+    "Interlogix GE UTC Security Devices", "Visonic powercode", \
+    "Honeywell Door/Window Sensor, 2Gig DW10/DW11, RE208 repeater", "X10 Security", \
+    "Yale HSA (Home Security Alarm), YES-Alarmkit" // names of the devices run first on urgent signals
+#define rtl_433_Decoder_Edge_Poll_MS PD_MIN_GAP_MS // edge ring polling period of the first worker
+#define rtl_433_Decoder_Pack_Words 1024 // 16-bit widths of a pooled queued signal, longer ones go to the heap
+#define rtl_433_Decoder_Stats_Reads 8 // tries of getDecoderStats() to read all counters consistently
 
 #include <cstring>
 #include <vector>
 
 extern "C" {
 #include "bitbuffer.h"
+#include "block_pool.h"
 #include "fatal.h"
 #include "list.h"
 #include "pulse_detect.h"
+#include "pulse_pack.h"
+#include "pulse_ring.h"
+#include "pulse_slicer.h"
 #include "r_api.h"
 #include "r_private.h"
 #include "rtl_433.h"
@@ -56,11 +67,136 @@ extern "C" {
 
 typedef void (*rtl_433_ESPCallBack)(char* message, void* ctx);
 
+/// Urgency class of a signal, urgent signals are decoded before any normal one
+typedef enum {
+  RTL_433_LANE_NORMAL, ///< e.g. weather stations and TPMS
+  RTL_433_LANE_URGENT, ///< e.g. door/window and alarm sensors
+  RTL_433_LANES,
+} rtl_433_lane_t;
+
+/// Slicer family to run on a signal
+typedef enum {
+  RTL_433_MODULATION_DEFAULT, ///< as set with setook()
+  RTL_433_MODULATION_OOK,
+  RTL_433_MODULATION_FSK,
+  RTL_433_MODULATION_AUTO, ///< guessed from the pulse timing, the other family runs if the guess decodes nothing
+} rtl_433_modulation_t;
+
 typedef struct decode_job {
-  pulse_data_t* rtl_pulses;
+  pulse_pack_t* pack; ///< the signal, packed while queued
   void* ctx;
+  rtl_433_modulation_t modulation;
+  unsigned source; ///< receiver the signal came from
+  rtl_433_lane_t lane;
+  int64_t submitted; ///< port_now_us() at processSignal(), for the lane latency and decoder_signal_time_us()
+  uint32_t seq; ///< submission order, results reach the callback in this order
+  int events; ///< decoded events, -1 if the signal was discarded
+  char** messages; ///< decoded messages held back until all earlier jobs are delivered
+  unsigned num_messages;
+  unsigned max_messages;
 } decode_job_t;
 
+/// What processSignal() does with a signal when the queue is full, see setQueue()
+typedef enum {
+  RTL_433_QUEUE_DROP_NEWEST, ///< discard the new signal
+  RTL_433_QUEUE_DROP_OLDEST, ///< discard the oldest queued signal to make room for the new one
+  RTL_433_QUEUE_BLOCK, ///< wait up to the timeout for room, then discard the new signal
+  RTL_433_QUEUE_COALESCE, ///< discard a repeat of the last normal signal of the source still waiting, else as RTL_433_QUEUE_DROP_NEWEST
+} rtl_433_queue_policy_t;
+
+/// Queue counters
+typedef struct rtl_433_queue_stats {
+  unsigned depth;
+  unsigned enqueued; ///< signals placed on the queue
+  unsigned dropped_newest; ///< new signals discarded as the queue was full
+  unsigned dropped_oldest; ///< queued signals discarded to make room, RTL_433_QUEUE_DROP_OLDEST
+  unsigned timeouts; ///< new signals discarded after waiting for room, RTL_433_QUEUE_BLOCK
+  unsigned coalesced; ///< repeats discarded, RTL_433_QUEUE_COALESCE
+  unsigned high_watermark; ///< most signals waiting in the queue at once, in the fullest one for the total of all sources
+} rtl_433_queue_stats_t;
+
+/// Per source counters, see setSource()
+typedef struct rtl_433_source_stats {
+  unsigned weight;
+  rtl_433_queue_stats_t queue; ///< counters of the queue of the source
+  unsigned decoded; ///< signals decoded
+  unsigned events; ///< events decoded
+} rtl_433_source_stats_t;
+
+/// Per lane counters, see processSignal()
+typedef struct rtl_433_lane_stats {
+  unsigned delivered; ///< signals decoded and delivered
+  unsigned latency_avg_us; ///< from processSignal() to the delivery of the messages
+  unsigned latency_max_us;
+} rtl_433_lane_stats_t;
+
+/// A receiver feeding the decoder, with its own queue
+typedef struct decode_source {
+  port_queue_t queue;
+  unsigned weight; ///< signals taken per round when the others also have some waiting
+  unsigned depth; ///< 0=as set with setQueue()
+  int credit; ///< smooth weighted round-robin, the source with most credit goes next
+  uint32_t lastSignature; ///< of the last queued normal signal, for RTL_433_QUEUE_COALESCE
+  rtl_433_source_stats_t stats;
+} decode_source_t;
+
+/// Signal pool counters
+typedef struct rtl_433_pool_stats {
+  block_pool_stats_t pulses; ///< pulse trains of processRaw(), processRFRaw() and acquirePulses(), until packed
+  block_pool_stats_t packs; ///< queued signals, packed
+  block_pool_stats_t jobs; ///< queued signals
+  unsigned heap_pulses; ///< pulse trains allocated from the heap as the pool was exhausted
+  unsigned heap_packs; ///< packed signals allocated from the heap as the pool was exhausted or they were too long
+  unsigned heap_jobs; ///< jobs allocated from the heap as the pool was exhausted
+  unsigned dropped_packs; ///< signals discarded as they could not be packed
+} rtl_433_pool_stats_t;
+
+/// Edge ring and packetizer counters
+typedef struct rtl_433_edge_stats {
+  unsigned packages; ///< pulse trains decoded
+  unsigned short_trains; ///< trains with less than PD_MIN_PULSES pulses, dropped
+  unsigned broken_trains; ///< trains that lost edges to a full ring, dropped
+  unsigned overflows; ///< edges dropped as the ring was full
+} rtl_433_edge_stats_t;
+
+class rtl_433_Decoder;
+struct decode_worker;
+
+/// Task running one partition of the decoders for a worker, see setParallelDispatch()
+typedef struct decode_helper {
+  struct decode_worker* worker;
+  unsigned part;
+  port_sem_t start; ///< given by the worker for each priority level to decode
+  port_task_t handle;
+} decode_helper_t;
+
+/// One decoder task, with its own decoder state so workers never share a device
+typedef struct decode_worker {
+  rtl_433_Decoder* decoder;
+  r_cfg_t* cfg; ///< g_cfg for the first worker
+  pulse_slicer_ctx_t* slicers[DISPATCH_MAX_PARTS]; ///< one per partition
+  decode_job_t* job; ///< job being decoded
+  port_task_t handle;
+
+  // intra-signal parallel dispatch
+  unsigned num_parts;
+  decode_helper_t* helpers; ///< num_parts - 1 helpers, the worker runs the first partition itself
+  port_sem_t done; ///< given by each helper when its partition of a level is done
+  port_sem_t outputLock; ///< partitions output concurrently
+  port_sem_t stateLock; ///< first worker only, held while decoding as the Sync calls share its state
+  pulse_data_t* pulses; ///< the job being decoded, unpacked
+  void (*partFn)(void* arg, unsigned part);
+  void* partArg;
+} decode_worker_t;
+
+/// Clear the fields of a pulse train besides the widths, they are written up to num_pulses before use.
+/// The per-pulse rssi[] of SIGNAL_RSSI builds is never read, so the cost is fixed and small enough for an ISR.
+static inline void clearPulses(pulse_data_t* rtl_pulses) {
+  memset(rtl_pulses, 0, offsetof(pulse_data_t, pulse));
+  memset(&rtl_pulses->ook_low_estimate, 0,
+      offsetof(pulse_data_t, signalDuration) + sizeof(rtl_pulses->signalDuration) - offsetof(pulse_data_t, ook_low_estimate));
+}
+
 class rtl_433_Decoder {
 public:
   // construct
@@ -77,33 +213,236 @@ public:
   //   when you are done with your own processing of it!  ctx is a context pointer you can optionally 
   //   set via the processRaw method.
   void setCallback(rtl_433_ESPCallBack callback);
-  // process rtl_433 format pulse_data_t pulses
-  void processSignal(pulse_data_t* rtl_pulses,void* ctx=nullptr);
+  /// @brief Decode with several worker tasks, call before rtlSetup()
+  /// Each worker keeps its own copy of the decoder state. Results still reach the callback in submission order.
+  /// Decoders remembering earlier messages, like the two halves of a Security+ (Keyfob) code, only join
+  /// messages decoded by the same worker, keep one worker if those matter.
+  /// @param count Number of worker tasks, 0=none, every signal is then decoded on the caller's thread.
+  ///        rtlSetup() logs and drops workers whose task fails to start
+  /// @param firstCore Core of the first worker, further workers go round the other cores. PORT_NO_AFFINITY to not pin them
+  void setWorkers(unsigned count, int firstCore = rtl_433_Decoder_Core);
+  /// @brief Size the signal queue and choose what happens to signals when it is full
+  /// The depth is fixed by rtlSetup(), the policy and timeout can change at any time.
+  /// @param depth Signals waiting for a worker, at least 1
+  /// @param policy What processSignal() discards when the queue is full
+  /// @param timeoutMs Longest wait for room with RTL_433_QUEUE_BLOCK
+  void setQueue(unsigned depth, rtl_433_queue_policy_t policy = RTL_433_QUEUE_DROP_NEWEST, unsigned timeoutMs = 0);
+  /// @brief Queue counters, to size the queue against bursts, summed over all sources
+  rtl_433_queue_stats_t getQueueStats();
+  /// @brief Declare a receiver feeding this decoder, call before rtlSetup()
+  /// Each source gets its own queue, and the workers take from them by weighted round-robin,
+  /// so a chatty receiver cannot starve the others. Messages then carry a "source" field.
+  /// @param source Source id, below rtl_433_Decoder_Max_Sources. Signals without one come from source 0
+  /// @param weight Signals taken from this source per round while others have signals waiting too, at least 1
+  /// @param depth Depth of its queue, 0=as set with setQueue()
+  void setSource(unsigned source, unsigned weight = 1, unsigned depth = 0);
+  /// @brief Counters of one source, all zero for an unknown source
+  rtl_433_source_stats_t getSourceStats(unsigned source);
+  /// @brief Run the urgent devices of each priority first on urgent signals, switchable at runtime
+  /// The urgent devices default to rtl_433_Decoder_Urgent_Devices, see setUrgentDevice().
+  /// @param urgentFirst true=urgent devices first, false=urgent signals only skip the queue
+  void setUrgentDispatch(bool urgentFirst);
+  /// @brief Add or remove a device from the urgent ones, call after rtlSetup()
+  /// @param name Device name as reported in the "protocol" field
+  /// @return Number of devices found, 0 before rtlSetup()
+  int setUrgentDevice(const char* name, bool urgent = true);
+  /// @brief Delivered signals and their latency in one lane
+  rtl_433_lane_stats_t getLaneStats(rtl_433_lane_t lane);
+  /// @brief Preallocate the pulse trains signals are queued with, call before rtlSetup()
+  /// Signals wait in the queues packed as 16-bit widths, sized to their pulses. Packs, jobs and the pulse
+  /// trains signals are assembled in come from fixed pools set up by rtlSetup(), so queueing a signal neither
+  /// fragments the heap nor clears a whole pulse_data_t. The heap is only used once a pool is exhausted,
+  /// or for a signal longer than rtl_433_Decoder_Pack_Words widths.
+  /// @param pulses Full pulse trains for processRaw(), processRFRaw() and acquirePulses(), 0=one per source plus one
+  /// @param packs Packed signals, 0=one per signal all queues hold plus one per worker
+  void setPool(unsigned pulses, unsigned packs = 0);
+  /// @brief Pool and heap fallback counters, to size the pool
+  rtl_433_pool_stats_t getPoolStats();
+  /// @brief Take a cleared pulse train from the pool, safe to call from an ISR, call after rtlSetup()
+  /// Inline and without heap fallback or logging, so an ISR placed in IRAM does not call into flash.
+  /// Fill num_pulses, pulse[] and gap[] in microseconds, then pass it to processSignal() from a task or releasePulses().
+  /// @return nullptr if the pool is exhausted
+  pulse_data_t* acquirePulses() {
+    pulse_data_t* rtl_pulses = (pulse_data_t*)block_pool_acquire(&_pulsePool);
+    if (rtl_pulses) {
+      clearPulses(rtl_pulses);
+    }
+    return rtl_pulses;
+  }
+  /// @brief Give back a pulse train of acquirePulses() that was not passed to processSignal(), safe to call from an ISR
+  void releasePulses(pulse_data_t* rtl_pulses) { block_pool_release(&_pulsePool, rtl_pulses); }
+  /// @brief Take raw edges through a lock-free ring instead of assembled signals, call before rtlSetup()
+  /// The first worker polls the ring every rtl_433_Decoder_Edge_Poll_MS and cuts it into pulse trains
+  /// with the PD_MIN_GAP_MS/PD_MAX_GAP_MS/PD_MAX_GAP_RATIO heuristics of pulse_data.h.
+  /// Its messages reach the callback in edge order, but outside the submission order of processSignal():
+  /// a train is delivered as soon as it is decoded, possibly ahead of signals still queued.
+  /// @param size Number of edges the ring holds, rounded up to a power of two
+  /// @param ctx Optional context pointer for callback
+  /// @param modulation Optional slicer family, defaults to the one set with setook()
+  void setEdgeRing(unsigned size, void* ctx = nullptr, rtl_433_modulation_t modulation = RTL_433_MODULATION_DEFAULT);
+  /// @brief Add a level change, safe to call from an ISR. Needs setEdgeRing()
+  /// @param timeUs Timestamp in microseconds from port_now_us(), truncated to 32 bits
+  /// @param level Level after the edge, 1=mark, 0=space
+  void pushEdge(uint32_t timeUs, int level) { pulse_ring_push(&_edgeRing, timeUs, level); }
+  /// @brief Edge ring counters, all zero without setEdgeRing()
+  rtl_433_edge_stats_t getEdgeStats();
+  /// @brief Decode each signal with the decoders split into partitions run concurrently, call before rtlSetup()
+  /// Each worker gets parts - 1 helper tasks on the following cores. Priority levels are kept, a level only
+  /// runs once all partitions of the previous one found nothing. Messages of one level may arrive in any order.
+  /// @param parts Number of partitions, 1=off, at most DISPATCH_MAX_PARTS
+  void setParallelDispatch(unsigned parts);
+  // process rtl_433 format pulse_data_t pulses, urgent signals go ahead of all normal ones in the queues
+  // rtl_pulses is freed once decoded, allocate it with calloc() or take it from acquirePulses()
+  void processSignal(pulse_data_t* rtl_pulses,void* ctx=nullptr,rtl_433_modulation_t modulation=RTL_433_MODULATION_DEFAULT,unsigned source=0,rtl_433_lane_t lane=RTL_433_LANE_NORMAL);
   /// @brief Process raw format data.
   /// @param rawdata Vector of on/mark (positive integer microseconds) and off/space (negative integer microseconds)
   /// @param ctx Optional context pointer for callback
-  void processRaw(const std::vector<int32_t>& rawdata,void* ctx=nullptr);
+  /// @param modulation Optional slicer family, defaults to the one set with setook()
+  /// @param source Optional receiver the signal came from, see setSource()
+  /// @param lane Optional urgency of the signal
+  void processRaw(const std::vector<int32_t>& rawdata,void* ctx=nullptr,rtl_433_modulation_t modulation=RTL_433_MODULATION_DEFAULT,unsigned source=0,rtl_433_lane_t lane=RTL_433_LANE_NORMAL);
+  /// @brief Decode a signal on the caller's thread, skipping the queue and the decoder task
+  /// The messages reach the callback before this returns, possibly ahead of signals still queued.
+  /// The caller's stack must fit a decoder, as rtl_433_DecoderTask does.
+  /// @param rtl_pulses Pulses in microseconds, still owned by the caller
+  /// @param ctx Optional context pointer for callback
+  /// @param modulation Optional slicer family, defaults to the one set with setook()
+  /// @param source Optional receiver the signal came from, only reported in the messages
+  /// @return Number of events decoded, -1 before rtlSetup()
+  int processSignalSync(pulse_data_t* rtl_pulses, void* ctx = nullptr, rtl_433_modulation_t modulation = RTL_433_MODULATION_DEFAULT, unsigned source = 0);
+  /// @brief Decode raw format data on the caller's thread, see processSignalSync() and processRaw()
+  /// @return Number of events decoded, -1 before rtlSetup()
+  int processRawSync(const std::vector<int32_t>& rawdata, void* ctx = nullptr, rtl_433_modulation_t modulation = RTL_433_MODULATION_DEFAULT, unsigned source = 0);
   /// @brief Process RF raw format data.
   /// @param p Pointer to RFraw null-term string data
   /// @param ctx Optional context pointer for callback
-  void processRFRaw(char const *p,void* ctx=nullptr);
+  /// @param modulation Optional slicer family, defaults to the one set with setook()
+  /// @param source Optional receiver the signal came from, see setSource()
+  /// @param lane Optional urgency of the signal
+  void processRFRaw(char const *p,void* ctx=nullptr,rtl_433_modulation_t modulation=RTL_433_MODULATION_DEFAULT,unsigned source=0,rtl_433_lane_t lane=RTL_433_LANE_NORMAL);
   /// @brief set modululation to ook
   /// @param ook true=ook, false=fsk
   void setook(bool ook) { _ookModulation=ook; }
+  /// @brief Order the decoders of each priority by how often they succeed, switchable at runtime
+  /// @param adaptive true=frequent winners run first, false=registration order
+  /// @param firstHitStop true=stop a priority at the first decoder returning events
+  /// @param costAware true=weigh the successes with the decode time, measured only while this is set, cheap winners run first
+  void setAdaptiveOrder(bool adaptive, bool firstHitStop = false, bool costAware = false);
+  /// @brief Try the decoder that matched a repeated timing signature first, switchable at runtime
+  /// @param slots Number of signatures remembered per modulation, 0=disabled
+  void setFingerprintCache(unsigned slots);
+  /// @brief Run decoders that never succeed on sampled signals only, promoting them back on a success
+  /// @param afterRuns Runs without a success before a decoder is demoted, 0=disabled
+  /// @param sample Demoted decoders run on one in this many signals, 0=default
+  void setDemotionPolicy(unsigned afterRuns, unsigned sample = 0);
+  /// @brief Limit the time spent decoding one signal, decoders not run yet are skipped once it is spent
+  /// @param budgetUs Budget in microseconds, 0=unlimited
+  void setDecodeBudget(unsigned budgetUs);
+  /// @brief JSON report of the demoted and budget-skipped decoders summed over all workers, nullptr before rtlSetup(). You *must* free() it.
+  char* getDispatchReport();
+  /// @brief Dispatcher counters summed over all workers, all zero before rtlSetup()
+  dispatch_stats_t getDispatchStats();
+  /// @brief Counters of the registered decoders summed over all workers, read without stopping them
+  /// @param stats Array for the counters in registration order, nullptr to query the count
+  /// @param count Size of stats
+  /// @return Number of registered decoders, 0 before rtlSetup() or if a decoder kept updating its counters
+  ///   during rtl_433_Decoder_Stats_Reads tries, stats is then incomplete and the call can be repeated
+  unsigned getDecoderStats(decoder_stats_t* stats, unsigned count);
+  /// @brief Save the decode times and successes learned by all workers, e.g. to NVS, so the order survives a reboot
+  /// @param buf Buffer for the model, nullptr to query the size
+  /// @param size Size of buf
+  /// @return Size of the model, nothing is written if buf is too small, 0 before rtlSetup()
+  size_t saveDispatchModel(void* buf, size_t size);
+  /// @brief Restore a model saved by saveDispatchModel() into all workers, call after rtlSetup() and before processing signals
+  /// @return Number of decoders restored, -1 if the model is not valid or before rtlSetup()
+  int loadDispatchModel(const void* buf, size_t size);
   unsigned int unparsedSignals = 0;
 
   r_cfg_t g_cfg; // Global config object
 
 protected:
   static void rtl_433_DecoderTask(void* pvParameters);
+  static void rtl_433_HelperTask(void* pvParameters);
+  static int runDemods(decode_worker_t* worker, bool ook, pulse_data_t* pulses);
+  static void workerFork(void* fork_ctx, void (*fn)(void* arg, unsigned part), void* arg, unsigned num_parts);
+  static void workerOutput(char* message, void* ctx);
+  void setupConfig(r_cfg_t* cfg);
+  std::vector<r_cfg_t*> workerConfigs();
+  int decodeJob(decode_worker_t* worker, decode_job_t* job, pulse_data_t* pulses);
+  void deliverJob(decode_job_t* job);
+  void commitJob(decode_job_t* job);
+  void drainEdges(decode_worker_t* worker);
+  void discardJob(decode_job_t* job);
+  int deliverSync(decode_job_t* job);
+  decode_job_t* nextJob();
+  pulse_data_t* newPulses();
+  void freePulses(pulse_data_t* rtl_pulses);
+  pulse_pack_t* packPulses(const pulse_data_t* rtl_pulses);
+  void freePack(pulse_pack_t* pack);
+  decode_job_t* newJob();
+  void freeJob(decode_job_t* job);
 
 private:
+  int adaptiveOrderMode() const {
+    return !_adaptiveOrder ? DISPATCH_ORDER_REGISTRATION : _costAware ? DISPATCH_ORDER_HITS_PER_COST : DISPATCH_ORDER_HITS;
+  }
   bool _ookModulation = true;
+  bool _adaptiveOrder = false;
+  bool _firstHitStop = false;
+  bool _costAware = false;
+  unsigned _fingerprintCacheSlots = 0;
+  unsigned _demoteAfterRuns = 0;
+  unsigned _demoteSample = 0;
+  unsigned _decodeBudgetUs = 0;
+  bool _urgentFirst = false;
 
   int rtlVerbose = 0;
 
-  TaskHandle_t rtl_433_DecoderHandle;
-  QueueHandle_t rtl_433_Queue;
+  rtl_433_ESPCallBack _callback = nullptr;
+  unsigned _workerCount = 1;
+  int _workerFirstCore = rtl_433_Decoder_Core;
+  unsigned _dispatchParts = 1;
+  unsigned _numWorkers = 0; ///< decoder states set up by rtlSetup(), one per worker and at least one
+  decode_worker_t* _workers = nullptr;
+  pulse_data_t* _syncPulses = nullptr; ///< reused by processRawSync()
+
+  // reorder stage, jobs are delivered in seq order
+  port_sem_t _reorderLock;
+  port_sem_t _reorderRoom; ///< counts free slots, a signal without one is discarded like on a full queue
+  decode_job_t** _reorderSlots = nullptr;
+  unsigned _reorderWindow = 0; ///< power of two
+  uint32_t _submitSeq = 0;
+  uint32_t _deliverSeq = 0;
+
+  // signal queues, one per source, counters are guarded by _reorderLock
+  unsigned _queueDepth = rtl_433_Decoder_Queue_Length;
+  rtl_433_queue_policy_t _queuePolicy = RTL_433_QUEUE_DROP_NEWEST;
+  unsigned _queueTimeoutMs = 0;
+  decode_source_t _sources[rtl_433_Decoder_Max_Sources] = {};
+  unsigned _numSources = 1;
+  port_sem_t _sourceLock; ///< guards the round-robin credits
+  port_sem_t _jobsReady; ///< given for each queued signal, may run ahead of the queues
+  port_queue_t _urgentQueue; ///< urgent signals of all sources, taken before any source queue
+  rtl_433_lane_stats_t _laneStats[RTL_433_LANES] = {};
+  uint64_t _laneLatencyUs[RTL_433_LANES] = {}; ///< summed, for the average
+
+  // edge ring, consumed by the first worker
+  pulse_ring_t _edgeRing = {};
+  pulse_packetizer_t _packetizer = {};
+  decode_job_t _edgeJob = {}; ///< reused for every pulse train of the ring, never takes a seq
+
+  // preallocated pulse trains and jobs
+  unsigned _pulsePoolSize = 0;
+  unsigned _packPoolSize = 0;
+  block_pool_t _pulsePool = {};
+  block_pool_t _packPool = {};
+  block_pool_t _jobPool = {};
+  unsigned _heapPulses = 0;
+  unsigned _heapPacks = 0;
+  unsigned _heapJobs = 0;
+  unsigned _droppedPacks = 0;
+
+  port_task_t rtl_433_DecoderHandle;
 };
 
 #endif
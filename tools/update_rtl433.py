@@ -8,11 +8,11 @@ import re
 # this script automates copy from a populated rtl_433 directory... it doesn't do any error checking
 # always review the results
 copy_exact="""include/c_util.h include/abuf.h include/bitbuffer.h include/compat_time.h 
-include/decoder.h include/decoder_util.h include/fatal.h include/list.h include/logger.h 
-include/optparse.h include/output_log.h include/pulse_detect.h include/pulse_slicer.h 
-include/r_api.h include/r_device.h include/r_util.h include/rfraw.h include/util.h
+include/decoder.h include/fatal.h include/list.h include/logger.h 
+include/optparse.h include/output_log.h include/pulse_detect.h 
+include/r_util.h include/rfraw.h include/util.h
 include/data.h include/bit_util.h
-src/abuf.c src/bitbuffer.c src/compat_time.c src/data.c src/decoder_util.c src/list.c
+src/abuf.c src/bitbuffer.c src/compat_time.c src/data.c src/list.c
 src/logger.c src/output_log.c src/pulse_data.c src/r_util.c src/util.c src/rfraw.c
 src/devices/*.c
 """.split()
@@ -22,9 +22,19 @@ exclude_list=set("""blueline deltadore_x3d rosstech_dcu706 secplus_v2""".split()
 
 # forked: manually review for updates
 #src/r_api.c
+#include/r_api.h
+#include/r_device.h
+#src/pulse_slicer.c
+#include/pulse_slicer.h
+#src/decoder_util.c
+#include/decoder_util.h
 #include/pulse_data.h
 #include/r_private.h
 #include/rtl_433.h
+#src/devices/{acurite,fineoffset,lacrosse,tpms}*.c: re-apply the .min_rows/.max_rows/.min_bits/.max_bits limits
+#  and the .preamble declarations (decoder_preamble_search()) after copying
+#src/devices/{secplus_v1,ikea_sparsnas}.c: keep the state in decode_ctx (.create_fn) and time
+#  secplus_v1 with decoder_signal_time_us() instead of gettimeofday()
 
 # todo - snapshot rtl_433 git repo version
 
@@ -81,13 +91,6 @@ def main():
     rtl433dir=Path(args.rtl433dir)
     outdir=Path(args.outdir)
 
-    # pulse_slicer.c: fix bitbuffer init to be portable and global because it's too big to allocate on the task stack
-    srcfile=rtl433dir / "src/pulse_slicer.c"
-    outfile=outdir / "src/rtl_433/pulse_slicer.c"
-    outfile.write_text(srcfile.read_text()
-                       .replace("bitbuffer_t bits = {0};","bitbuffer_clear(&bits);")
-                       .replace('#include <limits.h>',"#include <limits.h>\nbitbuffer_t bits;"))
-
     do_copy_exact(rtl433dir,outdir)
     update_rtl_433_devices(outdir)
 